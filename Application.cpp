@@ -1,12 +1,25 @@
 #include "Application.h"
 #include "Logger.h"
 #include "Command.h"
+#include "MemoryTracker.h"
+#include "Profiler.h"
+#include "LatencyHistogram.h"
 #include "classes/TicTacToe.h"
+#include "classes/GameRecord.h"
+#include "classes/GameAnalyzer.h"
+#include "classes/SessionManager.h"
 #include "imgui/imgui.h"
+#include "imgui/imgui_internal.h"
 #include <string>
 #include <vector>
+#include <memory>
+#include <cstdlib>
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <chrono>
+#include <random>
+#include <condition_variable>
 
 namespace ClassGame {
     
@@ -32,7 +45,183 @@ namespace ClassGame {
     
     // Command line input buffer and history
     static char InputBuf[256] = "";
+
+    // Binary record file finished games are streamed to (RECORD command)
+    static std::unique_ptr<GameRecordWriter> recordWriter;
+
+    // Idle-aware frame loop (see NeedsRedraw)
+    static const int kSettleFrames = 3;            // frames drawn after any change so layout and scrolling catch up
+    static const double kIdleWaitSeconds = 0.5;    // longest the platform loop blocks without an event
+    static bool idleFrames = true;                 // IDLE OFF draws every frame like before
+    static int redrawFrames = kSettleFrames;
+    static std::chrono::steady_clock::time_point lastFrameEnd = std::chrono::steady_clock::now();
+
+    // Rendered / skipped frame totals plus per-second rates, shown in the control panel (FRAMES command)
+    struct FrameCounter {
+        uint64_t rendered = 0;
+        uint64_t skipped = 0;
+        std::chrono::steady_clock::time_point windowStart = std::chrono::steady_clock::now();
+        int windowFrames = 0;
+        double windowSeconds = 0.0;
+        double windowMax = 0.0;
+        double fps = 0.0;
+        double averageMs = 0.0;
+        double maxMs = 0.0;
+    };
+    static FrameCounter frameCounter;
+
+    // Click -> endTurn -> swap timing (LATENCY command). A press that hasn't produced a turn within a few presented
+    // frames hit something else (a button, the log) and is dropped; turns without a pending press (console, AI) are ignored.
+    struct LatencyProbe {
+        static const int kMaxPendingFrames = 4;
+        bool enabled = false;
+        uint64_t pressNs = 0;       // pending press, 0 = none
+        int pressFrames = 0;        // frames presented since the press
+        uint64_t turnNs = 0;        // turn waiting for the swap that shows it
+        uint64_t turnPressNs = 0;
+        uint64_t presses = 0;
+        uint64_t unmatched = 0;
+        LatencyHistogram inputToTurn;
+        LatencyHistogram turnToPresent;
+        LatencyHistogram inputToPresent;
+    };
+    static LatencyProbe latencyProbe;
+
+    static uint64_t ProbeNow() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
     
+    // Ask imgui to rewrite the ini file soon (io.IniSavingRate), so a restart picks up the latest board
+    static void MarkGameStateDirty() {
+        if (ImGui::GetCurrentContext()) {
+            ImGui::MarkIniSettingsDirty();
+        }
+    }
+
+    void RequestRedraw(int frames) {
+        redrawFrames = std::max(redrawFrames, frames);
+    }
+
+    // Something to draw: queued input, the AI to move, a pending redraw request, or imgui timers
+    // (ini save, text caret) that only advance while frames are being rendered
+    bool NeedsRedraw() {
+        if (!idleFrames || redrawFrames > 0) {
+            return true;
+        }
+        ImGuiContext* context = ImGui::GetCurrentContext();
+        if (!context) {
+            return true;
+        }
+        if (context->InputEventsQueue.Size > 0) {
+            RequestRedraw(kSettleFrames);
+            return true;
+        }
+        if (GameWin && game && !gameOver && game->gameHasAI() && game->getCurrentPlayer() && game->getCurrentPlayer()->playerNumber() == 1) {
+            return true;
+        }
+        double idle = std::chrono::duration<double>(std::chrono::steady_clock::now() - lastFrameEnd).count();
+        if (context->SettingsDirtyTimer > 0.0f && idle >= context->SettingsDirtyTimer) {
+            return true;
+        }
+        return ImGui::GetIO().WantTextInput && idle >= kIdleWaitSeconds;
+    }
+
+    double IdleWaitSeconds() {
+        ImGuiContext* context = ImGui::GetCurrentContext();
+        if (context && context->SettingsDirtyTimer > 0.0f) {
+            return std::min(kIdleWaitSeconds, (double)context->SettingsDirtyTimer);
+        }
+        return kIdleWaitSeconds;
+    }
+
+    void FrameRendered(double frameSeconds) {
+        auto now = std::chrono::steady_clock::now();
+        lastFrameEnd = now;
+        if (redrawFrames > 0) {
+            redrawFrames--;
+        }
+
+        FrameCounter& counter = frameCounter;
+        counter.rendered++;
+        counter.windowFrames++;
+        counter.windowSeconds += frameSeconds;
+        counter.windowMax = std::max(counter.windowMax, frameSeconds);
+        double elapsed = std::chrono::duration<double>(now - counter.windowStart).count();
+        if (elapsed >= 1.0) {
+            counter.fps = counter.windowFrames / elapsed;
+            counter.averageMs = counter.windowSeconds * 1000.0 / counter.windowFrames;
+            counter.maxMs = counter.windowMax * 1000.0;
+            counter.windowStart = now;
+            counter.windowFrames = 0;
+            counter.windowSeconds = 0.0;
+            counter.windowMax = 0.0;
+        }
+    }
+
+    void FrameSkipped() {
+        frameCounter.skipped++;
+        // an idle second shows as 0 fps rather than keeping the last busy rate
+        auto now = std::chrono::steady_clock::now();
+        if (frameCounter.windowFrames == 0 && std::chrono::duration<double>(now - frameCounter.windowStart).count() >= 1.0) {
+            frameCounter.fps = 0.0;
+            frameCounter.windowStart = now;
+        }
+    }
+
+    void InputEvent(double ageSeconds) {
+        LatencyProbe& probe = latencyProbe;
+        if (!probe.enabled) return;
+        if (probe.pressNs) probe.unmatched++;
+        probe.pressNs = ProbeNow() - (uint64_t)(std::max(0.0, ageSeconds) * 1e9);
+        probe.pressFrames = 0;
+        probe.presses++;
+    }
+
+    // called from EndOfTurn, so only the human's turn is paired with the press that caused it
+    static void ProbeTurn() {
+        LatencyProbe& probe = latencyProbe;
+        if (!probe.enabled || !probe.pressNs) return;
+        uint64_t now = ProbeNow();
+        probe.inputToTurn.Record(now - probe.pressNs);
+        probe.turnNs = now;
+        probe.turnPressNs = probe.pressNs;
+        probe.pressNs = 0;
+    }
+
+    void FramePresented() {
+        LatencyProbe& probe = latencyProbe;
+        if (!probe.enabled) return;
+        uint64_t now = ProbeNow();
+        if (probe.turnNs) {
+            probe.turnToPresent.Record(now - probe.turnNs);
+            probe.inputToPresent.Record(now - probe.turnPressNs);
+            probe.turnNs = 0;
+        }
+        if (probe.pressNs && ++probe.pressFrames > LatencyProbe::kMaxPendingFrames) {
+            probe.pressNs = 0;
+            probe.unmatched++;
+        }
+    }
+
+    static std::vector<std::string> LatencySummary() {
+        const LatencyProbe& probe = latencyProbe;
+        return {
+            std::to_string(probe.presses) + " presses, " + std::to_string(probe.inputToPresent.Count()) + " placed a piece, " +
+                std::to_string(probe.unmatched) + " did not" + (probe.enabled ? "" : " (probe off)"),
+            "input -> endTurn: " + probe.inputToTurn.Summary("ms", 1e-6),
+            "endTurn -> swap:  " + probe.turnToPresent.Summary("ms", 1e-6),
+            "input -> swap:    " + probe.inputToPresent.Summary("ms", 1e-6),
+        };
+    }
+
+    static std::string FrameSummary() {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1) << frameCounter.rendered << " frames rendered, " << frameCounter.skipped
+            << " idle wakeups | " << frameCounter.fps << " fps | " << std::setprecision(2) << frameCounter.averageMs
+            << " ms avg, " << frameCounter.maxMs << " ms max" << (idleFrames ? "" : " (continuous)");
+        return out.str();
+    }
+
     void ResetGameCounter() {
         gameActCounter = 0;
     }
@@ -40,23 +229,494 @@ namespace ClassGame {
     void ResetGame() {
         if (!game) return;
         game->stopGame();
+        // startGame begins the new record on the writer the game already holds
         game->setUpBoard();
         gameOver = false;
         gameWinner = -1;
+        MarkGameStateDirty();
         LOG_INFO("Game reset - new game started");
     }
 
+    // Recompute the game-over flags after the board changed outside of EndOfTurn (undo / redo)
+    static void RefreshGameOver() {
+        Player *winner = game->checkForWinner();
+        gameOver = winner != nullptr || game->checkForDraw();
+        gameWinner = winner ? winner->playerNumber() + 1 : -1;
+    }
+
+    // Take back turns until the human is to move again, so the AI doesn't immediately replay
+    void UndoTurn() {
+        if (!game || !game->undoMove()) return;
+        while (game->gameHasAI() && game->getCurrentPlayer()->playerNumber() == 1 && game->undoMove()) {}
+        RefreshGameOver();
+        MarkGameStateDirty();
+        LOG_INFO_TAG("Undo - Board State: " + game->stateString(), "GAME");
+    }
+
+    void RedoTurn() {
+        if (!game || !game->redoMove()) return;
+        while (game->gameHasAI() && game->getCurrentPlayer()->playerNumber() == 1 && game->redoMove()) {}
+        RefreshGameOver();
+        MarkGameStateDirty();
+    }
+
+    // Console commands owned by the game layer
+    static void RegisterGameCommands() {
+        Command::RegisterCommand("RESET", "", "reset the game action counter", [](const Command::CommandArgs&) {
+            ResetGameCounter();
+            LOG_INFO_TAG("Game counter reset", "CMD");
+            return true;
+        });
+        Command::RegisterCommand("NEWGAME", "", "start a new game", [](const Command::CommandArgs&) {
+            ResetGame();
+            return game != nullptr;
+        });
+        Command::RegisterCommand("MOVE", "MOVE <0-8>", "place the current player's piece, the AI replies on its turn", [](const Command::CommandArgs& args) {
+            int square = args.GetInt(0, -1);
+            if (!game || gameOver || square < 0 || square > 8) {
+                LOG_ERROR_TAG("Usage: MOVE <0-8> while a game is in progress", "CMD");
+                return false;
+            }
+            if (!game->applyMove(square)) {
+                LOG_ERROR_TAG("Square " + std::to_string(square) + " is not empty", "CMD");
+                return false;
+            }
+            if (!gameOver && game->gameHasAI() && game->getCurrentPlayer()->playerNumber() == 1) {
+                game->updateAI();
+            }
+            return true;
+        });
+        Command::RegisterCommand("RECORD", "RECORD <file> | RECORD OFF", "stream games to a binary record file", [](const Command::CommandArgs& args) {
+            if (!game) return false;
+            game->setRecorder(nullptr);
+            recordWriter.reset();
+            if (!args.Has(0) || Command::Stricmp(args.Get(0).c_str(), "OFF") == 0) {
+                LOG_INFO_TAG("Game recording off", "CMD");
+                return true;
+            }
+            auto writer = std::make_unique<GameRecordWriter>();
+            if (!writer->open(args.Get(0), 3, 3)) {
+                LOG_ERROR_TAG("Cannot open record file: " + args.Get(0), "CMD");
+                return false;
+            }
+            recordWriter = std::move(writer);
+            game->setRecorder(recordWriter.get());
+            LOG_INFO_TAG("Recording games to " + args.Get(0) + " (" + std::to_string(recordWriter->gameCount()) + " already recorded)", "CMD");
+            return true;
+        });
+        Command::RegisterCommand("RECORDS", "RECORDS <file>", "summarize a record file", [](const Command::CommandArgs& args) {
+            GameRecordReader reader;
+            if (!reader.open(args.Get(0))) {
+                LOG_ERROR_TAG("Cannot read record file: " + args.Get(0), "CMD");
+                return false;
+            }
+            size_t results[4] = { 0, 0, 0, 0 };
+            for (size_t i = 0; i < reader.gameCount(); i++) {
+                results[reader.game(i).result & 3]++;
+            }
+            LOG_INFO_TAG(args.Get(0) + ": " + std::to_string(reader.gameCount()) + " games | X wins " + std::to_string(results[kRecordPlayer1Win]) +
+                         " | O wins " + std::to_string(results[kRecordPlayer2Win]) + " | draws " + std::to_string(results[kRecordDraw]), "CMD");
+            return true;
+        });
+        Command::RegisterCommand("ANALYZE", "ANALYZE <file...> [-t threads]", "scan record files on worker threads and report outcome statistics", [](const Command::CommandArgs& args) {
+            std::vector<std::string> paths;
+            int threads = 0;
+            for (size_t i = 0; i < args.Count(); i++) {
+                if (args.Get(i) == "-t" || args.Get(i) == "-T") {
+                    threads = args.GetInt(++i, 0);
+                } else {
+                    paths.push_back(args.Get(i));
+                }
+            }
+            if (paths.empty()) {
+                LOG_ERROR_TAG("Usage: ANALYZE <file...> [-t threads]", "CMD");
+                return false;
+            }
+            AnalyzerResult result = AnalyzeGameRecords(paths, threads);
+            for (const auto& error : result.errors) {
+                LOG_ERROR_TAG(error, "CMD");
+            }
+            for (const auto& line : result.stats.report()) {
+                LOG_INFO_TAG(line, "ANALYZE");
+            }
+            double seconds = std::max(result.seconds, 1e-9);
+            std::ostringstream rate;
+            rate << std::fixed << std::setprecision(1) << result.files << " file(s), " << (double)result.bytes / (1024.0 * 1024.0) << " MB in "
+                 << result.seconds * 1000.0 << " ms (" << (double)result.stats.games / seconds / 1e6 << " M games/s, "
+                 << (double)result.bytes / seconds / (1024.0 * 1024.0) << " MB/s)";
+            LOG_INFO_TAG(rate.str(), "ANALYZE");
+            // the files that were read are still reported, but one that couldn't be fails the command
+            return result.errors.empty();
+        });
+        Command::RegisterCommand("SELFPLAY", "SELFPLAY <games> <file> [seed]", "append random self-play games to a record file", [](const Command::CommandArgs& args) {
+            long long games = args.GetInt(0, 0);
+            if (games <= 0 || !args.Has(1)) {
+                LOG_ERROR_TAG("Usage: SELFPLAY <games> <file> [seed]", "CMD");
+                return false;
+            }
+            long long written = GenerateSelfPlayRecords(args.Get(1), games, (uint32_t)args.GetInt(2, 1));
+            if (written < 0) {
+                LOG_ERROR_TAG("Cannot open record file: " + args.Get(1), "CMD");
+                return false;
+            }
+            LOG_INFO_TAG("Wrote " + std::to_string(written) + " self-play games to " + args.Get(1), "CMD");
+            return true;
+        });
+        Command::RegisterCommand("REPLAY", "REPLAY <file> <game> [turns]", "load a recorded game onto the board (UNDO steps back through it)", [](const Command::CommandArgs& args) {
+            if (!game) return false;
+            GameRecordReader reader;
+            if (!reader.open(args.Get(0))) {
+                LOG_ERROR_TAG("Cannot read record file: " + args.Get(0), "CMD");
+                return false;
+            }
+            int index = args.GetInt(1, -1);
+            if (index < 0 || (size_t)index >= reader.gameCount()) {
+                LOG_ERROR_TAG("Game index out of range (0-" + std::to_string((int)reader.gameCount() - 1) + ")", "CMD");
+                return false;
+            }
+            const GameRecordEntry& entry = reader.game((size_t)index);
+            int turns = std::min(args.GetInt(2, entry.moveCount), (int)entry.moveCount);
+
+            // replayed moves are not recorded again; play continuing from the replayed board goes into a fresh record
+            ResetGame();
+            game->setRecorder(nullptr);
+            for (int i = 0; i < turns; i++) {
+                game->applyMove(entry.moveSquare(i));
+            }
+            game->setRecorder(recordWriter.get());
+            RefreshGameOver();
+            LOG_INFO_TAG("Replayed game " + std::to_string(index) + " (" + std::to_string(turns) + " of " + std::to_string(entry.moveCount) + " moves) - Board State: " + game->stateString(), "GAME");
+            return true;
+        });
+        Command::RegisterCommand("SESSIONS", "SESSIONS <count> [shards]", "play <count> concurrent hosted games (random moves vs the AI) and report throughput", [](const Command::CommandArgs& args) {
+            int count = args.GetInt(0, 0);
+            if (count <= 0) {
+                LOG_ERROR_TAG("Usage: SESSIONS <count> [shards]", "CMD");
+                return false;
+            }
+            auto start = std::chrono::steady_clock::now();
+            SessionManager sessions(args.GetInt(1, 0));
+            std::vector<SessionReply> replies((size_t)count);
+
+            // issue one request per live game, wait for the whole round
+            std::mutex roundMutex;
+            std::condition_variable roundCv;
+            size_t pending = 0;
+            auto finished = [&](size_t index) {
+                return [&, index](const SessionReply& reply) {
+                    replies[index] = reply;
+                    std::lock_guard<std::mutex> lock(roundMutex);
+                    if (--pending == 0) roundCv.notify_one();
+                };
+            };
+            auto waitRound = [&]() {
+                std::unique_lock<std::mutex> lock(roundMutex);
+                roundCv.wait(lock, [&] { return pending == 0; });
+            };
+
+            pending = (size_t)count;
+            for (int i = 0; i < count; i++) {
+                sessions.createAsync(2, finished((size_t)i));
+            }
+            waitRound();
+            size_t sessionBytes = sessions.memoryUsed();
+
+            std::mt19937 rng(1);
+            size_t requests = (size_t)count;
+            while (true) {
+                std::vector<size_t> live;
+                for (size_t i = 0; i < replies.size(); i++) {
+                    if (replies[i].status == kSessionOk && !replies[i].over) live.push_back(i);
+                }
+                if (live.empty()) break;
+                {
+                    std::lock_guard<std::mutex> lock(roundMutex);
+                    pending = live.size();
+                }
+                for (size_t index : live) {
+                    uint16_t empty = (uint16_t)(~(replies[index].cells[0] | replies[index].cells[1]) & TicTacToeBitboard::kFullBoard);
+                    int pick = (int)(rng() % (uint32_t)(9 - replies[index].moveCount));
+                    int square = 0;
+                    for (;; square++) {
+                        if ((empty & (1u << square)) && pick-- == 0) break;
+                    }
+                    sessions.moveAsync(replies[index].id, square, finished(index));
+                }
+                requests += live.size();
+                waitRound();
+            }
+
+            size_t results[3] = { 0, 0, 0 };
+            for (const auto& reply : replies) {
+                results[reply.winner < 0 ? 2 : reply.winner]++;
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::ostringstream summary;
+            summary << std::fixed << std::setprecision(1) << count << " sessions on " << sessions.shardCount() << " shard(s), "
+                    << (double)sessionBytes / count << " bytes/session | " << requests << " requests in " << seconds * 1000.0 << " ms ("
+                    << (double)requests / seconds / 1000.0 << " K req/s) | X " << results[0] << " | O (AI) " << results[1] << " | draws " << results[2];
+            LOG_INFO_TAG(summary.str(), "SESSIONS");
+            return true;
+        });
+        Command::RegisterCommand("FRAMES", "", "log the rendered / skipped frame counts and frame times", [](const Command::CommandArgs&) {
+            LOG_INFO_TAG(FrameSummary(), "CMD");
+            return true;
+        });
+        Command::RegisterCommand("PROFILE", "PROFILE [frames] | PROFILE ON|OFF", "log per-section frame timings over the last frames (default all kept)", [](const Command::CommandArgs& args) {
+            Profiler& profiler = Profiler::GetInstance();
+            if (args.Has(0) && (Command::Stricmp(args.Get(0).c_str(), "ON") == 0 || Command::Stricmp(args.Get(0).c_str(), "OFF") == 0)) {
+                profiler.SetEnabled(Command::Stricmp(args.Get(0).c_str(), "ON") == 0);
+                LOG_INFO_TAG(std::string("Frame profiler ") + (profiler.IsEnabled() ? "on" : "off"), "PROFILE");
+                return true;
+            }
+            for (const std::string& line : profiler.Report(args.GetInt(0, Profiler::kHistoryFrames))) {
+                LOG_INFO_TAG(line, "PROFILE");
+            }
+            return true;
+        });
+        Command::RegisterCommand("TRACE", "TRACE START|STOP|SAVE <file>", "capture PROFILE_SCOPE timings from every thread, save as Chrome trace JSON", [](const Command::CommandArgs& args) {
+            Tracer& tracer = Tracer::GetInstance();
+            std::string action = args.Get(0);
+            if (Command::Stricmp(action.c_str(), "START") == 0) {
+                tracer.Start();
+                LOG_INFO_TAG("Trace capture started", "TRACE");
+                return true;
+            }
+            if (Command::Stricmp(action.c_str(), "STOP") == 0) {
+                tracer.Stop();
+            } else if (Command::Stricmp(action.c_str(), "SAVE") == 0) {
+                std::string error;
+                if (!args.Has(1) || !tracer.Save(args.Get(1), &error)) {
+                    LOG_ERROR_TAG(args.Has(1) ? error : "Usage: TRACE SAVE <file>", "TRACE");
+                    return false;
+                }
+                LOG_INFO_TAG("Trace written to " + args.Get(1) + " (open in chrome://tracing or ui.perfetto.dev)", "TRACE");
+            }
+            uint64_t events, dropped;
+            int threads;
+            tracer.Counts(events, dropped, threads);
+            LOG_INFO_TAG(std::string(tracer.IsActive() ? "Capturing: " : "Stopped: ") + std::to_string(events) + " events on " +
+                         std::to_string(threads) + " thread(s), " + std::to_string(dropped) + " dropped", "TRACE");
+            return true;
+        });
+        Command::RegisterCommand("MEM", "MEM [MARK]", "log live / peak heap bytes and allocation counts per subsystem, MARK sets the baseline for deltas", [](const Command::CommandArgs& args) {
+            if (Command::Stricmp(args.Get(0).c_str(), "MARK") == 0) {
+                MemoryTracker::Mark();
+                LOG_INFO_TAG("Memory baseline marked", "MEM");
+                return true;
+            }
+            for (const std::string& line : MemoryTracker::Report()) {
+                LOG_INFO_TAG(line, "MEM");
+            }
+            std::string live = Entity::liveReport();
+            LOG_INFO_TAG("live entities: " + (live.empty() ? std::string("none") : live), "MEM");
+            return true;
+        });
+        Command::RegisterCommand("LATENCY", "LATENCY [ON|OFF|RESET]", "measure mouse press -> endTurn -> buffer swap latency, or log the distributions", [](const Command::CommandArgs& args) {
+            LatencyProbe& probe = latencyProbe;
+            std::string action = args.Get(0);
+            if (Command::Stricmp(action.c_str(), "ON") == 0 || Command::Stricmp(action.c_str(), "OFF") == 0) {
+                probe.enabled = Command::Stricmp(action.c_str(), "ON") == 0;
+                probe.pressNs = probe.turnNs = 0;
+                LOG_INFO_TAG(std::string("Input latency probe ") + (probe.enabled ? "on" : "off"), "LATENCY");
+                return true;
+            }
+            if (Command::Stricmp(action.c_str(), "RESET") == 0) {
+                bool enabled = probe.enabled;
+                probe = LatencyProbe();
+                probe.enabled = enabled;
+            }
+            for (const std::string& line : LatencySummary()) {
+                LOG_INFO_TAG(line, "LATENCY");
+            }
+            return true;
+        });
+        Command::RegisterCommand("IDLE", "IDLE ON|OFF", "only render on input / game activity (on) or every frame (off)", [](const Command::CommandArgs& args) {
+            if (args.Has(0)) {
+                idleFrames = Command::Stricmp(args.Get(0).c_str(), "OFF") != 0;
+            }
+            LOG_INFO_TAG(std::string("Idle frame skipping ") + (idleFrames ? "on" : "off"), "CMD");
+            return true;
+        });
+        Command::RegisterCommand("UNDO", "", "take back the last turn", [](const Command::CommandArgs&) {
+            UndoTurn();
+            return true;
+        });
+        Command::RegisterCommand("REDO", "", "replay the last undone turn", [](const Command::CommandArgs&) {
+            RedoTurn();
+            return true;
+        });
+        Command::RegisterCommand("HISTORY", "HISTORY [turn]", "log the move list, or the board after a turn", [](const Command::CommandArgs& args) {
+            if (!game) return false;
+            if (args.Has(0)) {
+                int turn = args.GetInt(0, 0);
+                LOG_INFO_TAG("Board after turn #" + std::to_string(turn) + ": " + game->stateStringAtTurn((size_t)turn), "GAME");
+                return true;
+            }
+            std::string moves;
+            const auto& turns = game->getTurns();
+            for (size_t i = 1; i < turns.size(); i++) {
+                moves += (i > 1 ? " " : "") + std::to_string(turns[i].player + 1) + ":" + std::to_string(turns[i].square);
+            }
+            LOG_INFO_TAG("Moves (player:square): " + (moves.empty() ? std::string("none") : moves), "GAME");
+            return true;
+        });
+        Command::RegisterCommand("STATE", "", "log the board state string", [](const Command::CommandArgs&) {
+            if (!game) return false;
+            LOG_INFO_TAG("Board State: " + game->stateString() + (gameOver ? " (game over)" : ""), "GAME");
+            return true;
+        });
+    }
+
+    //
+    // Game state in the imgui ini file
+    //
+    // [TicTacToe][Game]
+    // Board=120000000           final board, one char per square
+    // Start=000000000           board the move list starts from
+    // Moves=1:0:0 2:1:0         player:square:score per turn (player is 1-based)
+    // Redo=...                  undone turns, same format
+    // Windows=0,1,1,1           demo, log, game, control
+    // ClearColor=0.45,0.55,0.60
+    //
+    // The game is restored in one step from the saved history (Game::restoreTurns), no moves are replayed
+    //
+    struct SavedGame {
+        bool                    valid = false;
+        std::string             board;
+        std::string             start;
+        std::vector<TurnRecord> turns;
+        std::vector<TurnRecord> redoTurns;
+    };
+    static SavedGame savedGame;
+
+    static std::vector<TurnRecord> ParseSavedTurns(const char* text) {
+        std::vector<TurnRecord> turns;
+        std::istringstream stream(text);
+        std::string token;
+        while (stream >> token) {
+            int player = 0, square = -1, score = 0;
+            if (sscanf(token.c_str(), "%d:%d:%d", &player, &square, &score) < 2 || player < 1) {
+                break;
+            }
+            turns.push_back(TurnRecord{ (int16_t)square, (int16_t)score, (uint8_t)(player - 1) });
+        }
+        return turns;
+    }
+
+    static void AppendSavedTurns(ImGuiTextBuffer* buf, const char* key, const TurnRecord* turns, size_t count) {
+        buf->appendf("%s=", key);
+        for (size_t i = 0; i < count; i++) {
+            buf->appendf(i ? " %d:%d:%d" : "%d:%d:%d", turns[i].player + 1, turns[i].square, turns[i].score);
+        }
+        buf->append("\n");
+    }
+
+    static void* GameSettings_ReadOpen(ImGuiContext*, ImGuiSettingsHandler*, const char* name) {
+        if (strcmp(name, "Game") != 0) return nullptr;
+        savedGame = SavedGame();
+        savedGame.valid = true;
+        return &savedGame;
+    }
+
+    static void GameSettings_ReadLine(ImGuiContext*, ImGuiSettingsHandler*, void* entry, const char* line) {
+        SavedGame* saved = static_cast<SavedGame*>(entry);
+        int windows[4];
+        float color[3];
+        if (strncmp(line, "Board=", 6) == 0) {
+            saved->board = line + 6;
+        } else if (strncmp(line, "Start=", 6) == 0) {
+            saved->start = line + 6;
+        } else if (strncmp(line, "Moves=", 6) == 0) {
+            saved->turns = ParseSavedTurns(line + 6);
+        } else if (strncmp(line, "Redo=", 5) == 0) {
+            saved->redoTurns = ParseSavedTurns(line + 5);
+        } else if (sscanf(line, "Windows=%d,%d,%d,%d", &windows[0], &windows[1], &windows[2], &windows[3]) == 4) {
+            DemoWin = windows[0] != 0;
+            LogWin = windows[1] != 0;
+            GameWin = windows[2] != 0;
+            ControlWin = windows[3] != 0;
+        } else if (sscanf(line, "ClearColor=%f,%f,%f", &color[0], &color[1], &color[2]) == 3) {
+            colorR = color[0];
+            colorG = color[1];
+            colorB = color[2];
+            clearColor = ImVec4(colorR, colorG, colorB, 1.0f);
+        }
+    }
+
+    static void GameSettings_ApplyAll(ImGuiContext*, ImGuiSettingsHandler*) {
+        if (!game || !savedGame.valid) return;
+        savedGame.valid = false;
+
+        bool restored = game->restoreTurns(savedGame.start, savedGame.turns, savedGame.redoTurns) &&
+                        game->stateString() == savedGame.board;
+        if (!restored) {
+            // history doesn't match the board - keep the board and start a fresh history from it
+            restored = game->restoreTurns(savedGame.board, {}, {});
+        }
+        if (restored) {
+            RefreshGameOver();
+            LOG_INFO_TAG("Restored saved game (" + std::to_string(game->getTurns().size() - 1) + " turns) - Board State: " + game->stateString(), "GAME");
+        } else {
+            LOG_WARN("Saved game in the ini file is not a valid board, starting a new game");
+        }
+    }
+
+    static void GameSettings_WriteAll(ImGuiContext*, ImGuiSettingsHandler* handler, ImGuiTextBuffer* buf) {
+        if (!game) return;
+        const auto& turns = game->getTurns();
+        const auto& redoTurns = game->getRedoTurns();
+
+        buf->appendf("[%s][Game]\n", handler->TypeName);
+        buf->appendf("Board=%s\n", game->stateString().c_str());
+        buf->appendf("Start=%s\n", game->getStartState().c_str());
+        AppendSavedTurns(buf, "Moves", turns.data() + 1, turns.size() - 1);
+        AppendSavedTurns(buf, "Redo", redoTurns.data(), redoTurns.size());
+        buf->appendf("Windows=%d,%d,%d,%d\n", DemoWin ? 1 : 0, LogWin ? 1 : 0, GameWin ? 1 : 0, ControlWin ? 1 : 0);
+        buf->appendf("ClearColor=%.3f,%.3f,%.3f\n", colorR, colorG, colorB);
+        buf->append("\n");
+    }
+
+    // The ini file is read on the first NewFrame, after GameStartUp, so the handler only has to be registered here
+    static void RegisterGameSettingsHandler() {
+        if (!ImGui::GetCurrentContext()) return;
+        ImGuiSettingsHandler handler;
+        handler.TypeName = "TicTacToe";
+        handler.TypeHash = ImHashStr("TicTacToe");
+        handler.ReadOpenFn = GameSettings_ReadOpen;
+        handler.ReadLineFn = GameSettings_ReadLine;
+        handler.ApplyAllFn = GameSettings_ApplyAll;
+        handler.WriteAllFn = GameSettings_WriteAll;
+        ImGui::AddSettingsHandler(&handler);
+    }
+
     void GameStartUp() {
         // Initialize Logger
+        Tracer::GetInstance().SetThreadName("main");
         Logger::GetInstance().Init();
 
+        // Optional local collector for AI scores and game events (kept out of the UI filters)
+        if (const char* socketPath = std::getenv("TICTACTOE_LOG_SOCKET")) {
+            MEMORY_SCOPE(Logger);
+            LogFilter filter;
+            filter.includeTags = { "AI SCORE", "GAME" };
+            Logger::GetInstance().AddSink(std::make_unique<SocketSink>(socketPath))->SetFilter(filter);
+        }
+
         // Initialize TicTacToe game
-        game = new TicTacToe();
+        {
+            MEMORY_SCOPE(Game);
+            game = new TicTacToe();
+        }
+        game->setEndTurnHandler([](Game*) { EndOfTurn(); });
         game->setUpBoard();
         
         // Test log entry types/tags
         LOG_INFO("TicTacToe game initialized");
         LOG_INFO_TAG("Player 1: X | Player 2: O", "GAME");
+
+        RegisterGameCommands();
+        RegisterGameSettingsHandler();
         
         // Initialize control variables
         gameActCounter = 0;
@@ -69,7 +729,19 @@ namespace ClassGame {
         gameWinner = -1;
     }
 
+    void GameShutDown() {
+        delete game;
+        game = nullptr;
+
+        // every sprite, holder and piece belongs to the game, so anything left is a lost reference
+        std::string live = Entity::liveReport();
+        if (!live.empty()) {
+            LOG_WARN_TAG("Entities still alive at shutdown: " + live, "MEM");
+        }
+    }
+
     void RenderGame() {
+        PROFILE_SCOPE("RenderGame");
         
         // Create dock space
         ImGui::DockSpaceOverViewport();
@@ -81,6 +753,7 @@ namespace ClassGame {
 
         // Window #1 - TicTacToe Game Window
         if (GameWin && game) {
+            PROFILE_SCOPE("Game Window");
             ImGui::Begin("TicTacToe Game", &GameWin, ImGuiWindowFlags_NoScrollbar);
             
             // Display current player and game state
@@ -107,6 +780,18 @@ namespace ClassGame {
             if (!gameOver && ImGui::Button("Reset Game")) {
                 ResetGame();
             }
+            ImGui::SameLine();
+            ImGui::BeginDisabled(!game->canUndo());
+            if (ImGui::Button("Undo")) {
+                UndoTurn();
+            }
+            ImGui::EndDisabled();
+            ImGui::SameLine();
+            ImGui::BeginDisabled(!game->canRedo());
+            if (ImGui::Button("Redo")) {
+                RedoTurn();
+            }
+            ImGui::EndDisabled();
             
             ImGui::Separator();
             
@@ -118,6 +803,7 @@ namespace ClassGame {
 
         // Window #2 - Game Log with Command Line
         if (LogWin) {
+            PROFILE_SCOPE("Log Window");
             ImGui::Begin("Game Log", &LogWin);
 
             // Filter state variables
@@ -169,8 +855,9 @@ namespace ClassGame {
             ImGui::Separator();
 
             // Display log entries with filtering
-            const auto& entries = Logger::GetInstance().GetEntries();
-            const auto& colors = Logger::GetInstance().GetColors();
+            static std::vector<std::string> entries;
+            static std::vector<ImVec4> colors;
+            Logger::GetInstance().CopyEntries(entries, colors);
             
             const float footer_height = ImGui::GetStyle().ItemSpacing.y + ImGui::GetFrameHeightWithSpacing();
             ImGui::BeginChild("LogScrollRegion", ImVec2(0, -footer_height), true);
@@ -217,7 +904,7 @@ namespace ClassGame {
                 Command::Strtrim(s);
                 if (s[0])
                     Command::ExecCommand(s);
-                strcpy_s(s, IM_ARRAYSIZE(InputBuf), "");
+                s[0] = 0;
                 reclaim_focus = true;
             }
             
@@ -230,7 +917,7 @@ namespace ClassGame {
 
             ImGui::SameLine();
             if (ImGui::Button("Help")) {
-                LOG_INFO_TAG("Available commands: CLEAR, HELP, INFO, WARN, ERROR, RESET", "CMD");
+                Command::ShowHelp();
             }
 
             ImGui::End();
@@ -238,6 +925,7 @@ namespace ClassGame {
 
         // Window #3 - Game Control Panel
         if (ControlWin) {
+            PROFILE_SCOPE("Control Window");
             ImGui::Begin("Game Control", &ControlWin);
             ImGui::Text("Main Game Control Panel");
 
@@ -264,13 +952,7 @@ namespace ClassGame {
             ImGui::Text("TicTacToe Controls:");
             
             if (ImGui::Button("Reset TicTacToe")) {
-                if (game) {
-                    game->stopGame();
-                    game->setUpBoard();
-                    gameOver = false;
-                    gameWinner = -1;
-                    LOG_INFO("Game reset from control panel");
-                }
+                ResetGame();
             }
 
             // Game status display
@@ -288,6 +970,30 @@ namespace ClassGame {
                 }
             }
 
+            ImGui::Separator();
+            ImGui::Text("Frames: %s", FrameSummary().c_str());
+            ImGui::Checkbox("##IdleCheck", &idleFrames);
+            ImGui::SameLine();
+            ImGui::Text("Skip Idle Frames");
+            if (ImGui::CollapsingHeader("Frame Profiler")) {
+                Profiler::GetInstance().DrawPanel();
+            }
+            if (ImGui::CollapsingHeader("Memory")) {
+                MemoryTracker::DrawPanel();
+            }
+            if (ImGui::CollapsingHeader("Input Latency")) {
+                ImGui::Checkbox("Measure click -> display", &latencyProbe.enabled);
+                ImGui::SameLine();
+                if (ImGui::Button("Reset##Latency")) {
+                    bool enabled = latencyProbe.enabled;
+                    latencyProbe = LatencyProbe();
+                    latencyProbe.enabled = enabled;
+                }
+                for (const std::string& line : LatencySummary()) {
+                    ImGui::TextUnformatted(line.c_str());
+                }
+            }
+
             ImGui::Separator();
             // Visual controls
             ImGui::SliderFloat("##float", &floatVal, 0.0f, 1.0f, "%.3f");
@@ -333,6 +1039,10 @@ namespace ClassGame {
 
     void EndOfTurn() {
         if (!game) return;
+        ProbeTurn();
+        MarkGameStateDirty();
+        
+        RequestRedraw(kSettleFrames);
         
         // Check for winner or draw
         Player *winner = game->checkForWinner();
@@ -2,6 +2,23 @@
 
 namespace ClassGame {
     void GameStartUp();
+    // deletes the game and warns about entities that outlived it; after ImGui::DestroyContext, which saves the board
+    void GameShutDown();
     void RenderGame();
     void EndOfTurn();
+
+    // Idle-aware frame loop: the platform loop blocks for input (at most IdleWaitSeconds) while
+    // NeedsRedraw() is false and skips frames that would draw the same picture again
+    bool NeedsRedraw();
+    double IdleWaitSeconds();
+    // keep rendering for a few frames after something changed outside of input
+    void RequestRedraw(int frames = 3);
+    // frame counter, fed by the platform loop
+    void FrameRendered(double frameSeconds);
+    void FrameSkipped();
+
+    // Input latency probe (LATENCY ON): the platform layer timestamps mouse presses and buffer swaps, the game
+    // pairs them with the turn they caused. ageSeconds is how long the event sat in the OS queue, if known.
+    void InputEvent(double ageSeconds = 0.0);
+    void FramePresented();
 }
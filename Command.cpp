@@ -5,6 +5,11 @@
 #include <cctype>
 #include <cstring>
 #include <cstdlib>
+#include <algorithm>
+#include <unordered_map>
+#include <chrono>
+#include <fstream>
+#include <iostream>
 
 namespace ClassGame {
     namespace Command {
@@ -12,6 +17,28 @@ namespace ClassGame {
         // Static variables for command history
         static ImVector<char*> CommandHistory;
         static int HistoryPos = -1;
+
+        // Registered commands, keyed by upper-case name
+        struct CommandEntry {
+            std::string name;
+            std::string usage;
+            std::string help;
+            CommandHandler handler;
+        };
+
+        static std::unordered_map<std::string, CommandEntry>& Registry() {
+            static std::unordered_map<std::string, CommandEntry> registry;
+            return registry;
+        }
+
+        static std::string UpperName(const char* name, size_t length) {
+            std::string key(name, length);
+            for (char& c : key)
+                c = (char)toupper((unsigned char)c);
+            return key;
+        }
+
+        static void RegisterBuiltins();
         
         // Case-insensitive string compare
         int Stricmp(const char* s1, const char* s2) { 
@@ -49,10 +76,154 @@ namespace ClassGame {
             *str_end = 0; 
         }
         
-        // Execute command from command line
-        void ExecCommand(const char* command_line) {
+        // Split a command line into name + arguments
+        static std::vector<std::string> Tokenize(const char* line) {
+            std::vector<std::string> tokens;
+            const char* p = line;
+            while (*p) {
+                while (*p == ' ' || *p == '\t')
+                    p++;
+                if (!*p)
+                    break;
+                std::string token;
+                if (*p == '"') {
+                    p++;
+                    while (*p && *p != '"')
+                        token += *p++;
+                    if (*p == '"')
+                        p++;
+                } else {
+                    while (*p && *p != ' ' && *p != '\t')
+                        token += *p++;
+                }
+                tokens.push_back(std::move(token));
+            }
+            return tokens;
+        }
+
+        const std::string& CommandArgs::Get(size_t index) const {
+            static const std::string empty;
+            return index < _tokens.size() ? _tokens[index] : empty;
+        }
+
+        int CommandArgs::GetInt(size_t index, int fallback) const {
+            if (index >= _tokens.size())
+                return fallback;
+            char* end = nullptr;
+            long value = strtol(_tokens[index].c_str(), &end, 10);
+            return (end && *end == 0 && end != _tokens[index].c_str()) ? (int)value : fallback;
+        }
+
+        double CommandArgs::GetFloat(size_t index, double fallback) const {
+            if (index >= _tokens.size())
+                return fallback;
+            char* end = nullptr;
+            double value = strtod(_tokens[index].c_str(), &end);
+            return (end && *end == 0 && end != _tokens[index].c_str()) ? value : fallback;
+        }
+
+        std::string CommandArgs::Join(size_t from) const {
+            std::string joined;
+            for (size_t i = from; i < _tokens.size(); i++) {
+                if (i > from)
+                    joined += ' ';
+                joined += _tokens[i];
+            }
+            return joined;
+        }
+
+        void RegisterCommand(const char* name, const char* usage, const char* help, CommandHandler handler) {
+            std::string key = UpperName(name, strlen(name));
+            Registry()[key] = CommandEntry{ key, usage ? usage : "", help ? help : "", std::move(handler) };
+        }
+
+        bool UnregisterCommand(const char* name) {
+            return Registry().erase(UpperName(name, strlen(name))) > 0;
+        }
+
+        bool HasCommand(const char* name) {
+            RegisterBuiltins();
+            return Registry().count(UpperName(name, strlen(name))) > 0;
+        }
+
+        void ShowHelp() {
+            RegisterBuiltins();
+            std::vector<const CommandEntry*> sorted;
+            for (const auto& it : Registry())
+                sorted.push_back(&it.second);
+            std::sort(sorted.begin(), sorted.end(), [](const CommandEntry* a, const CommandEntry* b) { return a->name < b->name; });
+
+            std::string names;
+            for (const CommandEntry* entry : sorted)
+                names += (names.empty() ? "" : ", ") + entry->name;
+            LOG_INFO_TAG("Available commands: " + names, "CMD");
+            for (const CommandEntry* entry : sorted) {
+                std::string usage = entry->usage.empty() ? entry->name : entry->usage;
+                LOG_INFO_TAG("  " + usage + (entry->help.empty() ? "" : " - " + entry->help), "CMD");
+            }
+        }
+
+        // Commands owned by the console itself; everything else is registered by its subsystem
+        static void RegisterBuiltins() {
+            static bool registered = false;
+            if (registered)
+                return;
+            registered = true;
+
+            RegisterCommand("CLEAR", "", "clear the log window", [](const CommandArgs&) {
+                Logger::GetInstance().Clear();
+                LOG_INFO_TAG("Log cleared via command", "CMD");
+                return true;
+            });
+            RegisterCommand("HELP", "", "list commands", [](const CommandArgs&) {
+                ShowHelp();
+                return true;
+            });
+            RegisterCommand("INFO", "INFO [message]", "log an info message", [](const CommandArgs& args) {
+                LOG_INFO(args.Has(0) ? args.Join() : "Test info message from command line");
+                return true;
+            });
+            RegisterCommand("WARN", "WARN [message]", "log a warning", [](const CommandArgs& args) {
+                LOG_WARN(args.Has(0) ? args.Join() : "Test warning message from command line");
+                return true;
+            });
+            RegisterCommand("EXEC", "EXEC <script>", "run a command script", [](const CommandArgs& args) {
+                if (!args.Has(0)) {
+                    LOG_ERROR_TAG("Usage: EXEC <script>", "CMD");
+                    return false;
+                }
+                // a script that can't be opened or has a failing command fails the EXEC line running it
+                return ExecScript(args.Get(0).c_str()) == 0;
+            });
+            RegisterCommand("ERROR", "ERROR [message]", "log an error", [](const CommandArgs& args) {
+                LOG_ERROR(args.Has(0) ? args.Join() : "Test error message from command line");
+                return true;
+            });
+        }
+
+        // Look up and run one command line
+        static bool Dispatch(const char* command_line) {
+            RegisterBuiltins();
             LOG_INFO_TAG(std::string("Command: ") + command_line, "CMD");
-            
+
+            std::vector<std::string> tokens = Tokenize(command_line);
+            if (tokens.empty())
+                return false;
+
+            auto it = Registry().find(UpperName(tokens[0].c_str(), tokens[0].size()));
+            if (it == Registry().end()) {
+                LOG_ERROR_TAG(std::string("Unknown command: '") + command_line + "'", "CMD");
+                return false;
+            }
+
+            tokens.erase(tokens.begin());
+            // copy the handler so a command may re-register itself while running
+            CommandHandler handler = it->second.handler;
+            return handler(CommandArgs(std::move(tokens)));
+        }
+
+        // Execute command from command line
+        bool ExecCommand(const char* command_line) {
             // Add to history (remove duplicates)
             HistoryPos = -1;
             for (int i = CommandHistory.Size - 1; i >= 0; i--) {
@@ -64,31 +235,66 @@ namespace ClassGame {
             }
             CommandHistory.push_back(Strdup(command_line));
             
-            // Process commands
-            if (Stricmp(command_line, "CLEAR") == 0) {
-                Logger::GetInstance().Clear();
-                LOG_INFO_TAG("Log cleared via command", "CMD");
-            }
-            else if (Stricmp(command_line, "HELP") == 0) {
-                LOG_INFO_TAG("Available commands: CLEAR, HELP, INFO, WARN, ERROR, RESET", "CMD");
-            }
-            else if (Stricmp(command_line, "RESET") == 0) {
-                // Access gameActCounter through a function in Application
-                // For now, just log it
-                LOG_INFO_TAG("Game counter reset", "CMD");
-            }
-            else if (Stricmp(command_line, "INFO") == 0) {
-                LOG_INFO("Test info message from command line");
-            }
-            else if (Stricmp(command_line, "WARN") == 0) {
-                LOG_WARN("Test warning message from command line");
+            return Dispatch(command_line);
+        }
+
+        bool ExecTimed(const char* command_line, double* elapsed_ms) {
+            auto start = std::chrono::steady_clock::now();
+            bool ok = Dispatch(command_line);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            char timing[64];
+            snprintf(timing, sizeof(timing), "%.3f ms", ms);
+            LOG_INFO_TAG(std::string("'") + command_line + "' " + (ok ? "took " : "failed after ") + timing, "CMD");
+            if (elapsed_ms)
+                *elapsed_ms = ms;
+            return ok;
+        }
+
+        int ExecStream(std::istream& in, const char* source_name) {
+            static int depth = 0;
+            if (depth >= 8) {
+                LOG_ERROR_TAG(std::string("Script nesting too deep: ") + source_name, "CMD");
+                return -1;
             }
-            else if (Stricmp(command_line, "ERROR") == 0) {
-                LOG_ERROR("Test error message from command line");
+            depth++;
+
+            int failures = 0;
+            int executed = 0;
+            double total_ms = 0.0;
+            std::string line;
+            while (std::getline(in, line)) {
+                // strip CR from scripts saved on Windows, then leading/trailing blanks
+                if (!line.empty() && line.back() == '\r')
+                    line.pop_back();
+                size_t first = line.find_first_not_of(" \t");
+                if (first == std::string::npos || line[first] == '#')
+                    continue;
+                line.erase(0, first);
+                Strtrim(line.data());
+                line.resize(strlen(line.c_str()));
+
+                double ms = 0.0;
+                if (!ExecTimed(line.c_str(), &ms))
+                    failures++;
+                executed++;
+                total_ms += ms;
             }
-            else {
-                LOG_ERROR_TAG(std::string("Unknown command: '") + command_line + "'", "CMD");
+
+            char summary[128];
+            snprintf(summary, sizeof(summary), "%d commands, %d failed, %.3f ms total", executed, failures, total_ms);
+            LOG_INFO_TAG(std::string(source_name) + ": " + summary, "CMD");
+            depth--;
+            return failures;
+        }
+
+        int ExecScript(const char* path) {
+            std::ifstream in(path);
+            if (!in.is_open()) {
+                LOG_ERROR_TAG(std::string("Cannot open script: ") + path, "CMD");
+                return -1;
             }
+            return ExecStream(in, path);
         }
         
         // Callback for input text - handles command history navigation
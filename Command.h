@@ -1,16 +1,58 @@
 #pragma once
 #include "imgui/imgui.h"
+#include <string>
+#include <vector>
+#include <functional>
+#include <iosfwd>
 
 namespace ClassGame {
     namespace Command {
+
+        // Arguments following the command name, split on whitespace ("quoted text" stays one argument)
+        class CommandArgs {
+        public:
+            CommandArgs() = default;
+            explicit CommandArgs(std::vector<std::string> tokens) : _tokens(std::move(tokens)) {}
+
+            size_t              Count() const { return _tokens.size(); }
+            bool                Has(size_t index) const { return index < _tokens.size(); }
+            // empty string when the argument is missing
+            const std::string&  Get(size_t index) const;
+            // fallback when the argument is missing or not a number
+            int                 GetInt(size_t index, int fallback) const;
+            double              GetFloat(size_t index, double fallback) const;
+            // arguments from index onward joined with single spaces
+            std::string         Join(size_t from = 0) const;
+
+        private:
+            std::vector<std::string> _tokens;
+        };
+
+        // returns false when the command failed (bad arguments, nothing to act on, an I/O error), after logging why
+        using CommandHandler = std::function<bool(const CommandArgs& args)>;
+
+        // Command registry - names are case-insensitive, registering an existing name replaces it
+        void RegisterCommand(const char* name, const char* usage, const char* help, CommandHandler handler);
+        bool UnregisterCommand(const char* name);
+        bool HasCommand(const char* name);
+        // Log every registered command with its usage
+        void ShowHelp();
+
         // String helper functions
         int Stricmp(const char* s1, const char* s2);
         int Strnicmp(const char* s1, const char* s2, int n);
         char* Strdup(const char* s);
         void Strtrim(char* s);
         
-        // Command execution
-        void ExecCommand(const char* command_line);
+        // Command execution - returns false for an unknown command or one whose handler failed
+        bool ExecCommand(const char* command_line);
+
+        // Batch execution (no history), each command's wall time is logged
+        bool ExecTimed(const char* command_line, double* elapsed_ms = nullptr);
+        // Run every line that isn't blank or a # comment; returns the number of failed commands,
+        // or -1 if the script can't be opened
+        int ExecScript(const char* path);
+        int ExecStream(std::istream& in, const char* source_name);
         
         // Input callback for history navigation
         int TextEditCallbackStub(ImGuiInputTextCallbackData* data);
@@ -0,0 +1,73 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace ClassGame {
+
+LatencyHistogram::LatencyHistogram() : counts(kBucketCount, 0) {
+}
+
+// values < 2 * kSubBuckets map to themselves, larger ones keep their top kSubBucketBits + 1 bits
+int LatencyHistogram::BucketFor(uint64_t value) {
+    if (value < 2 * kSubBuckets) return (int)value;
+    int msb = 63;
+    while (!(value >> msb)) msb--;
+    int shift = msb - kSubBucketBits;
+    return (shift + 1) * kSubBuckets + (int)(value >> shift) - kSubBuckets;
+}
+
+uint64_t LatencyHistogram::BucketHighest(int bucket) {
+    if (bucket < 2 * kSubBuckets) return (uint64_t)bucket;
+    int shift = bucket / kSubBuckets - 1;
+    uint64_t lowest = (uint64_t)(bucket % kSubBuckets + kSubBuckets) << shift;
+    return lowest + ((uint64_t)1 << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t value) {
+    counts[BucketFor(value)]++;
+    count++;
+    sum += value;
+    min = std::min(min, value);
+    max = std::max(max, value);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+    for (int i = 0; i < kBucketCount; i++) {
+        counts[i] += other.counts[i];
+    }
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+void LatencyHistogram::Reset() {
+    std::fill(counts.begin(), counts.end(), 0);
+    count = 0;
+    sum = 0;
+    min = UINT64_MAX;
+    max = 0;
+}
+
+uint64_t LatencyHistogram::Percentile(double percentile) const {
+    if (count == 0) return 0;
+    uint64_t rank = (uint64_t)(std::clamp(percentile, 0.0, 100.0) / 100.0 * (double)count + 0.5);
+    rank = std::clamp<uint64_t>(rank, 1, count);
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; i++) {
+        seen += counts[i];
+        if (seen >= rank) return std::min(BucketHighest(i), max);
+    }
+    return max;
+}
+
+std::string LatencyHistogram::Summary(const char* unit, double scale) const {
+    char text[256];
+    snprintf(text, sizeof(text), "n=%llu mean=%.1f%s p50=%.1f p90=%.1f p99=%.1f p99.9=%.1f max=%.1f%s",
+             (unsigned long long)count, Mean() * scale, unit,
+             Percentile(50.0) * scale, Percentile(90.0) * scale, Percentile(99.0) * scale, Percentile(99.9) * scale,
+             Max() * scale, unit);
+    return text;
+}
+
+}
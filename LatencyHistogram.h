@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ClassGame {
+
+// Log-linear latency histogram (HDR style): values below 64 are exact, above that each power of two
+// is split into 32 linear buckets, so any recorded value is reported within ~3% using a fixed 15 KB.
+// Recording is a couple of shifts and an increment; histograms from different threads merge by adding counts.
+// Not thread safe - give each thread its own and Merge() them.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void Record(uint64_t value);
+    void Merge(const LatencyHistogram& other);
+    void Reset();
+
+    uint64_t Count() const { return count; }
+    uint64_t Min() const { return count ? min : 0; }
+    uint64_t Max() const { return max; }
+    double Mean() const { return count ? (double)sum / (double)count : 0.0; }
+    // highest value equivalent to the given percentile (0-100)
+    uint64_t Percentile(double percentile) const;
+
+    // "n=1000 mean=12.3 p50=10.0 p90=... p99=... p99.9=... max=..." with values multiplied by scale
+    std::string Summary(const char* unit = "us", double scale = 1e-3) const;
+
+    static constexpr int kSubBucketBits = 5;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+private:
+    static int BucketFor(uint64_t value);
+    static uint64_t BucketHighest(int bucket);
+
+    std::vector<uint64_t> counts;
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t min = UINT64_MAX;
+    uint64_t max = 0;
+};
+
+}
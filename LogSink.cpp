@@ -0,0 +1,466 @@
+#include "LogSink.h"
+#include "MemoryTracker.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#ifdef LOGGER_HAS_ZLIB
+#include <zlib.h>
+#endif
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#endif
+
+namespace ClassGame {
+
+const char* LogLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Warning: return "WARN";
+        case LogLevel::Error:   return "ERROR";
+        default:                return "INFO";
+    }
+}
+
+bool LogFilter::Accepts(const LogRecord& record) const {
+    if (record.level < minLevel) return false;
+    if (!includeTags.empty() && std::find(includeTags.begin(), includeTags.end(), record.tag) == includeTags.end()) {
+        return false;
+    }
+    return std::find(excludeTags.begin(), excludeTags.end(), record.tag) == excludeTags.end();
+}
+
+// -----------------------------------------------------------------------------
+// LogSink
+// -----------------------------------------------------------------------------
+
+LogSink::LogSink(const std::string& sinkName, bool isThreaded)
+    : name(sinkName), threaded(isThreaded) {
+}
+
+LogSink::~LogSink() {
+    Stop();
+}
+
+void LogSink::Start() {
+    if (threaded && !deliveryThread.joinable()) {
+        stopping = false;
+        deliveryThread = std::thread(&LogSink::DeliveryLoop, this);
+    }
+}
+
+void LogSink::SetFilter(const LogFilter& newFilter) {
+    std::lock_guard<std::mutex> lock(filterMutex);
+    filter = newFilter;
+}
+
+LogFilter LogSink::GetFilter() const {
+    std::lock_guard<std::mutex> lock(filterMutex);
+    return filter;
+}
+
+void LogSink::Submit(const LogRecord& record) {
+    {
+        std::lock_guard<std::mutex> lock(filterMutex);
+        if (!filter.Accepts(record)) return;
+    }
+
+    if (!threaded) {
+        Write(record);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (queue.size() >= kMaxQueued) {
+            dropped++;
+            return;
+        }
+        queue.push_back(record);
+    }
+    queueCv.notify_one();
+}
+
+void LogSink::Stop() {
+    if (!deliveryThread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCv.notify_one();
+    deliveryThread.join();
+}
+
+// Delivery thread: drain everything queued, write it, then flush once per batch
+void LogSink::DeliveryLoop() {
+    MEMORY_SCOPE(Logger);
+    Tracer::GetInstance().SetThreadName("log " + name);
+    std::deque<LogRecord> batch;
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true) {
+        queueCv.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty()) break;
+
+        batch.swap(queue);
+        lock.unlock();
+        {
+            PROFILE_SCOPE("log delivery");
+            for (const auto& record : batch) {
+                Write(record);
+            }
+            Flush();
+        }
+        batch.clear();
+        lock.lock();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// FileSink
+// -----------------------------------------------------------------------------
+
+FileSink::FileSink(const std::string& filename, const LogRotation& rotationPolicy)
+    : LogSink("file", true), logFileName(filename), rotation(rotationPolicy) {
+    OpenLogFile();
+    compressorThread = std::thread(&FileSink::CompressorLoop, this);
+    Start();
+}
+
+FileSink::~FileSink() {
+    Stop();
+    {
+        std::lock_guard<std::mutex> lock(compressorMutex);
+        compressorStop = true;
+    }
+    compressorCv.notify_one();
+    if (compressorThread.joinable()) {
+        compressorThread.join();
+    }
+    if (logFile.is_open()) {
+        logFile.close();
+    }
+}
+
+// Open (append) the active log file and pick up its current size and when it was started
+// The start time lives in a "<file>.start" sidecar (seconds since the epoch), so a process that restarts
+// and appends to the same file keeps aging it instead of starting the maxFileAge clock over
+void FileSink::OpenLogFile() {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(logFileName, ec);
+    logFileBytes = ec ? 0 : static_cast<size_t>(size);
+    auto now = std::chrono::system_clock::now();
+    logFileOpened = now;
+
+    std::string startPath = logFileName + ".start";
+    long long startSeconds = 0;
+    if (logFileBytes > 0) {
+        std::ifstream start(startPath);
+        if (start >> startSeconds) {
+            logFileOpened = std::chrono::system_clock::time_point(std::chrono::seconds(startSeconds));
+        } else {
+            // file from before the sidecar existed: it is at least as old as its last write
+            auto written = std::filesystem::last_write_time(logFileName, ec);
+            if (!ec) {
+                logFileOpened = now + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    written - std::filesystem::file_time_type::clock::now());
+            }
+        }
+        logFileOpened = std::min(logFileOpened, now);
+    }
+    if (logFileBytes == 0 || startSeconds == 0) {
+        std::ofstream start(startPath, std::ios::trunc);
+        start << std::chrono::duration_cast<std::chrono::seconds>(logFileOpened.time_since_epoch()).count() << "\n";
+    }
+    logFile.open(logFileName, std::ios::app);
+}
+
+void FileSink::Write(const LogRecord& record) {
+    if (!logFile.is_open()) return;
+
+    logFile << record.text << "\n";
+    logFileBytes += record.text.size() + 1;
+
+    auto now = std::chrono::system_clock::now();
+    bool tooBig = rotation.maxFileBytes > 0 && logFileBytes >= rotation.maxFileBytes;
+    bool tooOld = rotation.maxFileAge.count() > 0 && now - logFileOpened >= rotation.maxFileAge;
+    if (tooBig || tooOld) {
+        RotateLogFile(now);
+    }
+}
+
+void FileSink::Flush() {
+    if (logFile.is_open()) {
+        logFile.flush();
+    }
+}
+
+// Rename the active file to <stem>-YYYYMMDD-HHMMSS-N<ext> and start a fresh one
+// Compression and retention are handed to the compressor thread
+void FileSink::RotateLogFile(std::chrono::system_clock::time_point now) {
+    logFile.close();
+
+    std::time_t t = std::chrono::system_clock::to_time_t(now);
+    std::tm tm;
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+
+    std::filesystem::path path(logFileName);
+    std::filesystem::path rolled = path.parent_path() /
+        (path.stem().string() + "-" + stamp + "-" + std::to_string(rotationSequence++) + path.extension().string());
+
+    std::error_code ec;
+    std::filesystem::rename(path, rolled, ec);
+    OpenLogFile();
+
+    if (!ec) {
+        {
+            std::lock_guard<std::mutex> lock(compressorMutex);
+            compressorQueue.push_back(rolled.string());
+        }
+        compressorCv.notify_one();
+    }
+}
+
+namespace {
+    // gzip a rolled file next to itself and remove the original
+    void CompressRolledFile(const std::string& path) {
+    #ifdef LOGGER_HAS_ZLIB
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) return;
+        std::string gzPath = path + ".gz";
+        gzFile out = gzopen(gzPath.c_str(), "wb6");
+        if (!out) return;
+
+        char buffer[64 * 1024];
+        bool ok = true;
+        while (in) {
+            in.read(buffer, sizeof(buffer));
+            std::streamsize count = in.gcount();
+            if (count > 0 && gzwrite(out, buffer, static_cast<unsigned>(count)) != static_cast<int>(count)) {
+                ok = false;
+                break;
+            }
+        }
+        ok = (gzclose(out) == Z_OK) && ok;
+        in.close();
+
+        std::error_code ec;
+        std::filesystem::remove(ok ? std::filesystem::path(path) : std::filesystem::path(gzPath), ec);
+    #else
+        (void)path;
+    #endif
+    }
+
+    // count digits starting at pos, advancing pos past them
+    size_t SkipDigits(const std::string& name, size_t& pos) {
+        size_t start = pos;
+        while (pos < name.size() && name[pos] >= '0' && name[pos] <= '9') pos++;
+        return pos - start;
+    }
+
+    // Only names RotateLogFile produces, <stem>-YYYYMMDD-HHMMSS-N<ext> optionally with .gz,
+    // so other files sharing the stem (game_log-debug.txt) are never counted or deleted
+    bool IsRolledLogName(const std::string& name, const std::string& stem, const std::string& extension) {
+        size_t pos = stem.size() + 1;
+        if (name.size() < pos || name.compare(0, stem.size(), stem) != 0 || name[stem.size()] != '-') return false;
+        if (SkipDigits(name, pos) != 8 || pos >= name.size() || name[pos++] != '-') return false;
+        if (SkipDigits(name, pos) != 6 || pos >= name.size() || name[pos++] != '-') return false;
+        if (SkipDigits(name, pos) == 0) return false;
+        std::string rest = name.substr(pos);
+        return rest == extension || rest == extension + ".gz";
+    }
+
+    // Keep only the newest maxRetained rolled files
+    void PruneRolledFiles(const std::string& logFileName, int maxRetained) {
+        if (maxRetained <= 0) return;
+
+        std::filesystem::path path(logFileName);
+        std::filesystem::path dir = path.parent_path().empty() ? std::filesystem::path(".") : path.parent_path();
+        std::string stem = path.stem().string();
+        std::string extension = path.extension().string();
+
+        std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> rolled;
+        std::error_code ec;
+        for (const auto& file : std::filesystem::directory_iterator(dir, ec)) {
+            std::string name = file.path().filename().string();
+            if (IsRolledLogName(name, stem, extension) && file.is_regular_file(ec)) {
+                rolled.emplace_back(file.last_write_time(ec), file.path());
+            }
+        }
+        if (rolled.size() <= static_cast<size_t>(maxRetained)) return;
+
+        std::sort(rolled.begin(), rolled.end());
+        for (size_t i = 0; i + maxRetained < rolled.size(); i++) {
+            std::filesystem::remove(rolled[i].second, ec);
+        }
+    }
+}
+
+// Background worker: compresses rolled files and enforces the retained-file cap
+void FileSink::CompressorLoop() {
+    MEMORY_SCOPE(Logger);
+    Tracer::GetInstance().SetThreadName("log compressor");
+    std::unique_lock<std::mutex> lock(compressorMutex);
+    while (true) {
+        compressorCv.wait(lock, [this] { return compressorStop || !compressorQueue.empty(); });
+        if (compressorQueue.empty()) break;
+
+        std::string path = compressorQueue.front();
+        compressorQueue.pop_front();
+        lock.unlock();
+
+        {
+            PROFILE_SCOPE("compress rolled log");
+            if (rotation.compress) {
+                CompressRolledFile(path);
+            }
+            PruneRolledFiles(logFileName, rotation.maxRetainedFiles);
+        }
+
+        lock.lock();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// ConsoleSink
+// -----------------------------------------------------------------------------
+
+ConsoleSink::ConsoleSink() : LogSink("console", true) {
+    Start();
+}
+
+ConsoleSink::~ConsoleSink() {
+    Stop();
+}
+
+void ConsoleSink::Write(const LogRecord& record) {
+    fputs(record.text.c_str(), stdout);
+    fputc('\n', stdout);
+}
+
+void ConsoleSink::Flush() {
+    fflush(stdout);
+}
+
+// -----------------------------------------------------------------------------
+// MemorySink
+// -----------------------------------------------------------------------------
+
+MemorySink::MemorySink(size_t maxEntries) : LogSink("memory", false), capacity(maxEntries) {
+    Start();
+}
+
+MemorySink::~MemorySink() {
+    Stop();
+}
+
+void MemorySink::Write(const LogRecord& record) {
+    entries.push_back(record.text);
+    colors.push_back(record.color);
+
+    if (entries.size() > capacity) {
+        entries.erase(entries.begin());
+        colors.erase(colors.begin());
+    }
+}
+
+void MemorySink::CopyTo(std::vector<std::string>& entriesOut, std::vector<ImVec4>& colorsOut) const {
+    entriesOut = entries;
+    colorsOut = colors;
+}
+
+void MemorySink::Clear() {
+    entries.clear();
+    colors.clear();
+}
+
+// -----------------------------------------------------------------------------
+// SocketSink
+// -----------------------------------------------------------------------------
+
+SocketSink::SocketSink(const std::string& path) : LogSink("socket", true), socketPath(path) {
+    Start();
+}
+
+SocketSink::~SocketSink() {
+    Stop();
+    Disconnect();
+}
+
+#ifndef _WIN32
+
+bool SocketSink::Connect() {
+    if (socketFd >= 0) return true;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now < nextConnectAttempt) return false;
+    nextConnectAttempt = now + std::chrono::seconds(1);
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(addr.sun_path)) return false;
+    memcpy(addr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return false;
+    }
+    // never let a stalled collector back up the delivery thread
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    socketFd = fd;
+    return true;
+}
+
+void SocketSink::Disconnect() {
+    if (socketFd >= 0) {
+        close(socketFd);
+        socketFd = -1;
+    }
+}
+
+void SocketSink::Write(const LogRecord& record) {
+    if (!Connect()) return;
+
+    std::string line = record.text;
+    line += '\n';
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    ssize_t sent = send(socketFd, line.data(), line.size(), flags);
+    if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return;     // collector is behind, drop this line
+    }
+    if (sent != static_cast<ssize_t>(line.size())) {
+        // error or a torn line; reconnect so the collector never sees a half entry followed by more data
+        Disconnect();
+    }
+}
+
+#else
+
+// Unix-domain sockets are not wired up for the Win32 build; records are dropped
+bool SocketSink::Connect() { return false; }
+void SocketSink::Disconnect() { socketFd = -1; }
+void SocketSink::Write(const LogRecord& record) { (void)record; }
+
+#endif
+
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include "imgui/imgui.h"
+
+namespace ClassGame {
+
+enum class LogLevel {
+    Info = 0,
+    Warning = 1,
+    Error = 2
+};
+
+const char* LogLevelName(LogLevel level);
+
+// One formatted log line as handed to every sink
+struct LogRecord {
+    LogLevel level = LogLevel::Info;
+    std::string tag;
+    std::string text;       // "[HH:MM:SS.mmm] [LEVEL] [TAG] message"
+    ImVec4 color;
+};
+
+// Per-sink filtering by level and tag
+// An empty includeTags list accepts every tag (including untagged entries)
+struct LogFilter {
+    LogLevel minLevel = LogLevel::Info;
+    std::vector<std::string> includeTags;
+    std::vector<std::string> excludeTags;
+
+    bool Accepts(const LogRecord& record) const;
+};
+
+// Rolling policy for the log file
+// A value of 0 disables that limit
+struct LogRotation {
+    size_t maxFileBytes = 8 * 1024 * 1024;                   // roll once the active file reaches this size
+    std::chrono::seconds maxFileAge = std::chrono::hours(24); // roll once the active file is this old
+    int maxRetainedFiles = 8;                                 // rolled files kept on disk, oldest removed first
+    bool compress = true;                                     // gzip rolled files (needs zlib at build time)
+};
+
+//
+// base class for log destinations
+// threaded sinks own a delivery thread and a bounded queue so a slow destination never stalls the caller
+//
+class LogSink {
+public:
+    LogSink(const std::string& name, bool threaded);
+    virtual ~LogSink();
+
+    const std::string& GetName() const { return name; }
+    void SetFilter(const LogFilter& newFilter);
+    LogFilter GetFilter() const;
+
+    // filter and deliver (inline, or queued for the delivery thread)
+    void Submit(const LogRecord& record);
+    // drain the queue and join the delivery thread
+    void Stop();
+
+    size_t GetDropped() const { return dropped.load(); }
+
+    static constexpr size_t kMaxQueued = 16 * 1024;
+
+protected:
+    // must be called at the end of a derived constructor so Write() is never reached half-built
+    void Start();
+    virtual void Write(const LogRecord& record) = 0;
+    virtual void Flush() {}
+
+private:
+    void DeliveryLoop();
+
+    std::string name;
+    bool threaded;
+    mutable std::mutex filterMutex;
+    LogFilter filter;
+
+    std::thread deliveryThread;
+    std::mutex queueMutex;
+    std::condition_variable queueCv;
+    std::deque<LogRecord> queue;
+    bool stopping = false;
+    std::atomic<size_t> dropped{ 0 };
+};
+
+// game_log.txt with size/age rotation and off-thread compression
+class FileSink : public LogSink {
+public:
+    FileSink(const std::string& filename, const LogRotation& rotation = LogRotation());
+    ~FileSink() override;
+
+protected:
+    void Write(const LogRecord& record) override;
+    void Flush() override;
+
+private:
+    void OpenLogFile();
+    void RotateLogFile(std::chrono::system_clock::time_point now);
+    void CompressorLoop();
+
+    std::ofstream logFile;
+    std::string logFileName;
+    LogRotation rotation;
+    size_t logFileBytes = 0;
+    std::chrono::system_clock::time_point logFileOpened;   // when the active file was started, across restarts
+    int rotationSequence = 0;
+
+    // Rolled files waiting to be compressed and pruned off the logging path
+    std::thread compressorThread;
+    std::mutex compressorMutex;
+    std::condition_variable compressorCv;
+    std::deque<std::string> compressorQueue;
+    bool compressorStop = false;
+};
+
+// stdout
+class ConsoleSink : public LogSink {
+public:
+    ConsoleSink();
+    ~ConsoleSink() override;
+
+protected:
+    void Write(const LogRecord& record) override;
+    void Flush() override;
+};
+
+// entries shown in the Game Log window
+// written inline by whichever thread logs, under Logger's sink lock; the UI reads them through
+// Logger::CopyEntries, which takes the same lock
+class MemorySink : public LogSink {
+public:
+    explicit MemorySink(size_t capacity = 1000);
+    ~MemorySink() override;
+
+    // caller holds Logger's sink lock
+    void CopyTo(std::vector<std::string>& entriesOut, std::vector<ImVec4>& colorsOut) const;
+    void Clear();
+
+protected:
+    void Write(const LogRecord& record) override;
+
+private:
+    size_t capacity;
+    std::vector<std::string> entries;
+    std::vector<ImVec4> colors;
+};
+
+// newline-delimited entries streamed to a local collector listening on a Unix-domain socket
+// records are dropped (not buffered) while the collector is away; reconnects are rate limited
+class SocketSink : public LogSink {
+public:
+    explicit SocketSink(const std::string& socketPath);
+    ~SocketSink() override;
+
+protected:
+    void Write(const LogRecord& record) override;
+
+private:
+    bool Connect();
+    void Disconnect();
+
+    std::string socketPath;
+    int socketFd = -1;
+    std::chrono::steady_clock::time_point nextConnectAttempt;
+};
+
+}
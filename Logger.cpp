@@ -1,102 +1,187 @@
 #include "Logger.h"
-#include <iomanip>
-#include <sstream>
+#include "MemoryTracker.h"
+#include "Profiler.h"
+#include <cstring>
+#include <ctime>
 
 namespace ClassGame {
 
 // Logger initialization and system feedback
-void Logger::Init(const std::string& filename) {
+void Logger::Init(const std::string& filename, const LogRotation& rotation) {
     if (initialized) return;
+    MEMORY_SCOPE(Logger);
     
-    logFile.open(filename, std::ios::app);
-    if (logFile.is_open()) {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        
-        char timeStr[26];
-        ctime_s(timeStr, sizeof(timeStr), &time_t);
-    }
+    AddSink(std::make_unique<FileSink>(filename, rotation));
+    memorySink = static_cast<MemorySink*>(AddSink(std::make_unique<MemorySink>()));
+    #ifdef _DEBUG
+    AddSink(std::make_unique<ConsoleSink>());
+    #endif
     
     initialized = true;
     Info("Game started successfully");
     Info("Application initialized", "GAME");
 }
 
+void Logger::Shutdown() {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    sinks.clear();
+    memorySink = nullptr;
+    initialized = false;
+}
+
+LogSink* Logger::AddSink(std::unique_ptr<LogSink> sink) {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    sinks.push_back(std::move(sink));
+    return sinks.back().get();
+}
+
+void Logger::RemoveSink(LogSink* sink) {
+    std::unique_ptr<LogSink> removed;
+    {
+        std::lock_guard<std::mutex> lock(sinkMutex);
+        for (auto it = sinks.begin(); it != sinks.end(); ++it) {
+            if (it->get() == sink) {
+                removed = std::move(*it);
+                sinks.erase(it);
+                break;
+            }
+        }
+        if (sink == memorySink) {
+            memorySink = nullptr;
+        }
+    }
+    // joins the delivery thread outside the lock
+}
+
+LogSink* Logger::FindSink(const std::string& name) {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    for (auto& sink : sinks) {
+        if (sink->GetName() == name) return sink.get();
+    }
+    return nullptr;
+}
+
+// Per-thread cache of the "[HH:MM:SS." prefix
+// localtime and the digit formatting only run when the wall-clock second changes
+namespace {
+    struct TimestampCache {
+        std::time_t second = -1;
+        char prefix[10];    // "[HH:MM:SS."
+    };
+    thread_local TimestampCache timestampCache;
+
+    inline void PutTwoDigits(char* out, int value) {
+        out[0] = static_cast<char>('0' + value / 10);
+        out[1] = static_cast<char>('0' + value % 10);
+    }
+
+    // Writes "[HH:MM:SS.mmm] " (15 chars) into out
+    void FormatTimestamp(char* out, std::chrono::system_clock::time_point now) {
+        auto sinceEpoch = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch());
+        std::time_t second = static_cast<std::time_t>(sinceEpoch.count() / 1000);
+        int ms = static_cast<int>(sinceEpoch.count() % 1000);
+
+        TimestampCache& cache = timestampCache;
+        if (second != cache.second) {
+            std::tm tm;
+        #ifdef _WIN32
+            localtime_s(&tm, &second);
+        #else
+            localtime_r(&second, &tm);
+        #endif
+            cache.prefix[0] = '[';
+            PutTwoDigits(cache.prefix + 1, tm.tm_hour);
+            cache.prefix[3] = ':';
+            PutTwoDigits(cache.prefix + 4, tm.tm_min);
+            cache.prefix[6] = ':';
+            PutTwoDigits(cache.prefix + 7, tm.tm_sec);
+            cache.prefix[9] = '.';
+            cache.second = second;
+        }
+
+        memcpy(out, cache.prefix, sizeof(cache.prefix));
+        out[10] = static_cast<char>('0' + ms / 100);
+        out[11] = static_cast<char>('0' + (ms / 10) % 10);
+        out[12] = static_cast<char>('0' + ms % 10);
+        out[13] = ']';
+        out[14] = ' ';
+    }
+}
+
 // Define entry pattern - timestamp, tag, and message
-// Outputs to Game Log Window, console, and game_log.txt (in Debug folder or local)
-void Logger::AddEntry(const std::string& level, const std::string& message, const std::string& tag, const ImVec4& color) {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()
-    ) % 1000;
-    
-    std::stringstream ss;
-    
-    std::tm tm;
-    localtime_s(&tm, &time_t);
-    
+// Formatted once, then handed to every sink whose filter accepts it
+// (Game Log Window, game_log.txt, console, local collectors)
+void Logger::AddEntry(LogLevel level, const std::string& message, const std::string& tag, const ImVec4& color) {
+    PROFILE_SCOPE("Logger::AddEntry");
+    MEMORY_SCOPE(Logger);
+    const char* levelName = LogLevelName(level);
+
     // Format: [HH:MM:SS.mmm]
-    ss << "["
-       << std::setfill('0') 
-       << std::setw(2) << tm.tm_hour << ":"
-       << std::setw(2) << tm.tm_min << ":"
-       << std::setw(2) << tm.tm_sec
-       << "." << std::setw(3) << ms.count()
-       << "] ";
+    char timestamp[15];
+    FormatTimestamp(timestamp, std::chrono::system_clock::now());
+
+    LogRecord record;
+    record.level = level;
+    record.tag = tag;
+    record.color = color;
+
+    std::string& entry = record.text;
+    entry.reserve(sizeof(timestamp) + strlen(levelName) + tag.size() + message.size() + 6);
+    entry.append(timestamp, sizeof(timestamp));
     
     // Add level: [INFO], [WARN], [ERROR]
-    ss << "[" << level << "] ";
+    entry += '[';
+    entry += levelName;
+    entry += "] ";
     
     // Add tag ([GAME])
     if (!tag.empty()) {
-        ss << "[" << tag << "] ";
+        entry += '[';
+        entry += tag;
+        entry += "] ";
     }
     
     // Add the actual message
-    ss << message;
-    
-    std::string entry = ss.str();
-    entries.push_back(entry);
-    colors.push_back(color);
+    entry += message;
     
-    if (entries.size() > 1000) {
-        entries.erase(entries.begin());
-        colors.erase(colors.begin());
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    for (auto& sink : sinks) {
+        sink->Submit(record);
     }
-    
-    // Write to file
-    if (logFile.is_open()) {
-        logFile << entry << "\n";
-        logFile.flush();
-    }
-    
-    // Also print to console
-    #ifdef _DEBUG
-    printf("%s\n", entry.c_str());
-    #endif
 }
 
 void Logger::Info(const std::string& message, const std::string& tag) {
-    AddEntry("INFO", message, tag, ImVec4(1.0f, 1.0f, 1.0f, 1.0f)); // White
+    AddEntry(LogLevel::Info, message, tag, ImVec4(1.0f, 1.0f, 1.0f, 1.0f)); // White
 }
 
 void Logger::Warning(const std::string& message, const std::string& tag) {
-    AddEntry("WARN", message, tag, ImVec4(1.0f, 1.0f, 0.0f, 1.0f)); // Yellow
+    AddEntry(LogLevel::Warning, message, tag, ImVec4(1.0f, 1.0f, 0.0f, 1.0f)); // Yellow
 }
 
 void Logger::Error(const std::string& message, const std::string& tag) {
-    AddEntry("ERROR", message, tag, ImVec4(1.0f, 0.0f, 0.0f, 1.0f)); // Red
+    AddEntry(LogLevel::Error, message, tag, ImVec4(1.0f, 0.0f, 0.0f, 1.0f)); // Red
 }
 
 // Specific way to assign or add tags and take priority of the first tag's color
 void Logger::GameEvent(const std::string& message) {
-    AddEntry("INFO", message, "GAME", ImVec4(1.0f, 1.0f, 1.0f, 1.0f)); // White with [GAME] tag
+    AddEntry(LogLevel::Info, message, "GAME", ImVec4(1.0f, 1.0f, 1.0f, 1.0f)); // White with [GAME] tag
+}
+
+void Logger::CopyEntries(std::vector<std::string>& entries, std::vector<ImVec4>& colors) {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    if (memorySink) {
+        memorySink->CopyTo(entries, colors);
+    } else {
+        entries.clear();
+        colors.clear();
+    }
 }
 
 void Logger::Clear() {
-    entries.clear();
-    colors.clear();
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    if (memorySink) {
+        memorySink->Clear();
+    }
 }
 
 }
\ No newline at end of file
@@ -2,8 +2,9 @@
 
 #include <string>
 #include <vector>
-#include <fstream>
-#include <chrono>
+#include <memory>
+#include <mutex>
+#include "LogSink.h"
 #include "imgui/imgui.h"
 
 namespace ClassGame {
@@ -15,28 +16,36 @@ public:
         return instance;
     }
     
-    // Initialize
-    void Init(const std::string& filename = "game_log.txt");
+    // Initialize the default sinks (file, memory, and console in debug builds)
+    void Init(const std::string& filename = "game_log.txt", const LogRotation& rotation = LogRotation());
+    // Stop and flush every sink
+    void Shutdown();
     
     // Logging functions
     void Info(const std::string& message, const std::string& tag = "");
     void Warning(const std::string& message, const std::string& tag = "");
     void Error(const std::string& message, const std::string& tag = "");
     void GameEvent(const std::string& message);
+
+    // Sinks - the logger owns them; the returned pointer stays valid until RemoveSink/Shutdown
+    LogSink* AddSink(std::unique_ptr<LogSink> sink);
+    void RemoveSink(LogSink* sink);
+    LogSink* FindSink(const std::string& name);
     
-    // UI display
-    const std::vector<std::string>& GetEntries() const { return entries; }
-    const std::vector<ImVec4>& GetColors() const { return colors; }
+    // UI display - a snapshot of the Game Log entries and their colors taken under the sink lock, so another thread
+    // logging meanwhile can't reallocate them mid-read; reusing the same vectors every frame keeps their capacity
+    void CopyEntries(std::vector<std::string>& entries, std::vector<ImVec4>& colors);
     void Clear();
     
 private:
     Logger() = default;
-    void AddEntry(const std::string& level, const std::string& message, 
+    ~Logger() { Shutdown(); }
+    void AddEntry(LogLevel level, const std::string& message, 
                  const std::string& tag, const ImVec4& color);
     
-    std::vector<std::string> entries;
-    std::vector<ImVec4> colors;
-    std::ofstream logFile;
+    std::mutex sinkMutex;
+    std::vector<std::unique_ptr<LogSink>> sinks;
+    MemorySink* memorySink = nullptr;
     bool initialized = false;
 };
 
@@ -0,0 +1,267 @@
+#include "MemoryTracker.h"
+#include "imgui/imgui.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace ClassGame {
+
+namespace {
+
+// constant-initialized, so allocations made before main (or after static destruction) are counted safely
+struct alignas(64) TagCounters {
+    std::atomic<uint64_t> allocations{ 0 };
+    std::atomic<uint64_t> frees{ 0 };
+    std::atomic<int64_t> liveBytes{ 0 };
+    std::atomic<int64_t> peakBytes{ 0 };
+    std::atomic<uint64_t> totalBytes{ 0 };
+};
+
+TagCounters counters[MemoryTracker::kTagCount];
+MemoryTracker::Stats marks[MemoryTracker::kTagCount];
+bool marked = false;
+
+const char* const kTagNames[MemoryTracker::kTagCount] = { "General", "Game", "Logger", "ImGui", "Textures", "Sessions", "Network" };
+
+// sits right in front of every tracked block
+struct BlockHeader {
+    void* base;         // what malloc returned
+    size_t size;        // as requested
+    uint32_t tag;
+    uint32_t magic;
+};
+constexpr uint32_t kBlockMagic = 0x4d454d54;
+
+void Count(MemoryTag tag, int64_t bytes, bool allocation) {
+    TagCounters& counter = counters[(int)tag];
+    if (allocation) {
+        counter.allocations.fetch_add(1, std::memory_order_relaxed);
+        counter.totalBytes.fetch_add((uint64_t)bytes, std::memory_order_relaxed);
+    } else {
+        counter.frees.fetch_add(1, std::memory_order_relaxed);
+        bytes = -bytes;
+    }
+    int64_t live = counter.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t peak = counter.peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !counter.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+std::string FormatBytes(int64_t bytes) {
+    char text[32];
+    double magnitude = (double)(bytes < 0 ? -bytes : bytes);
+    if (magnitude >= 1024.0 * 1024.0) snprintf(text, sizeof(text), "%.2f MB", bytes / (1024.0 * 1024.0));
+    else if (magnitude >= 1024.0) snprintf(text, sizeof(text), "%.1f KB", bytes / 1024.0);
+    else snprintf(text, sizeof(text), "%lld B", (long long)bytes);
+    return text;
+}
+
+void* ImGuiAllocate(size_t size, void*) {
+    return MemoryTracker::Allocate(size, 0, MemoryTag::ImGui);
+}
+
+void ImGuiFree(void* block, void*) {
+    MemoryTracker::Free(block);
+}
+
+}
+
+const char* MemoryTracker::TagName(MemoryTag tag) {
+    return (int)tag < kTagCount ? kTagNames[(int)tag] : "?";
+}
+
+MemoryTracker::Stats MemoryTracker::Get(MemoryTag tag) {
+    const TagCounters& counter = counters[(int)tag];
+    Stats stats;
+    stats.allocations = counter.allocations.load(std::memory_order_relaxed);
+    stats.frees = counter.frees.load(std::memory_order_relaxed);
+    stats.liveBytes = counter.liveBytes.load(std::memory_order_relaxed);
+    stats.peakBytes = counter.peakBytes.load(std::memory_order_relaxed);
+    stats.totalBytes = counter.totalBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool MemoryTracker::IsTracking() {
+#ifdef GAME_MEMORY_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MemoryTracker::RecordExternal(MemoryTag tag, int64_t bytes) {
+    if (bytes != 0) {
+        Count(tag, bytes < 0 ? -bytes : bytes, bytes > 0);
+    }
+}
+
+void* MemoryTracker::Allocate(size_t size, size_t alignment, MemoryTag tag) {
+    // malloc already aligns for any standard type, over-aligned requests get padding to align by hand
+    bool overAligned = alignment > alignof(std::max_align_t);
+    if (!overAligned) {
+        alignment = alignof(std::max_align_t);
+    }
+    size_t offset = (sizeof(BlockHeader) + alignment - 1) & ~(alignment - 1);
+    size_t extra = offset + (overAligned ? alignment : 0);
+    if (size > SIZE_MAX - extra) {
+        return nullptr;
+    }
+    char* base = (char*)malloc(size + extra);
+    if (!base) {
+        return nullptr;
+    }
+    uintptr_t start = (uintptr_t)base + sizeof(BlockHeader);
+    char* block = overAligned ? (char*)((start + alignment - 1) & ~(uintptr_t)(alignment - 1)) : base + offset;
+
+    BlockHeader* header = (BlockHeader*)block - 1;
+    header->base = base;
+    header->size = size;
+    header->tag = (uint32_t)tag;
+    header->magic = kBlockMagic;
+    Count(tag, (int64_t)size, true);
+    return block;
+}
+
+void MemoryTracker::Free(void* block) {
+    if (!block) {
+        return;
+    }
+    BlockHeader* header = (BlockHeader*)block - 1;
+    IM_ASSERT(header->magic == kBlockMagic && "block was not allocated by MemoryTracker");
+    header->magic = 0;
+    Count((MemoryTag)header->tag, (int64_t)header->size, false);
+    free(header->base);
+}
+
+void MemoryTracker::InstallImGuiAllocator() {
+    ImGui::SetAllocatorFunctions(ImGuiAllocate, ImGuiFree, nullptr);
+}
+
+void MemoryTracker::Mark() {
+    for (int i = 0; i < kTagCount; i++) {
+        marks[i] = Get((MemoryTag)i);
+    }
+    marked = true;
+}
+
+std::vector<std::string> MemoryTracker::Report() {
+    std::vector<std::string> lines;
+    char line[256];
+    if (!IsTracking()) {
+        lines.push_back("heap tracking is compiled out (GAME_MEMORY_TRACKING), only ImGui and textures are counted");
+    }
+    snprintf(line, sizeof(line), "%-9s %11s %11s %12s %12s %11s%s", "tag", "live", "peak", "allocs", "frees", "blocks",
+             marked ? "   since mark: allocs / live" : "");
+    lines.push_back(line);
+
+    Stats total;
+    for (int i = 0; i < kTagCount; i++) {
+        Stats stats = Get((MemoryTag)i);
+        total.allocations += stats.allocations;
+        total.frees += stats.frees;
+        total.liveBytes += stats.liveBytes;
+        total.peakBytes += stats.peakBytes;
+        std::string sinceMark;
+        if (marked) {
+            sinceMark = "   " + std::to_string(stats.allocations - marks[i].allocations) + " / " +
+                        (stats.liveBytes >= marks[i].liveBytes ? "+" : "") + FormatBytes(stats.liveBytes - marks[i].liveBytes);
+        }
+        snprintf(line, sizeof(line), "%-9s %11s %11s %12llu %12llu %11lld%s", kTagNames[i], FormatBytes(stats.liveBytes).c_str(),
+                 FormatBytes(stats.peakBytes).c_str(), (unsigned long long)stats.allocations, (unsigned long long)stats.frees,
+                 (long long)(stats.allocations - stats.frees), sinceMark.c_str());
+        lines.push_back(line);
+    }
+    // the total peak is the sum of per-tag peaks, an upper bound on the real one
+    snprintf(line, sizeof(line), "%-9s %11s %11s %12llu %12llu %11lld", "total", FormatBytes(total.liveBytes).c_str(),
+             FormatBytes(total.peakBytes).c_str(), (unsigned long long)total.allocations, (unsigned long long)total.frees,
+             (long long)(total.allocations - total.frees));
+    lines.push_back(line);
+    return lines;
+}
+
+void MemoryTracker::DrawPanel() {
+    if (!IsTracking()) {
+        ImGui::TextDisabled("heap tracking compiled out, ImGui and textures only");
+    }
+    if (ImGui::Button("Mark##Memory")) {
+        Mark();
+    }
+    ImGui::SameLine();
+    ImGui::TextDisabled(marked ? "deltas since the last mark" : "mark to see changes, e.g. across game resets");
+
+    if (!ImGui::BeginTable("##MemoryTags", marked ? 6 : 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+        return;
+    }
+    ImGui::TableSetupColumn("Tag");
+    ImGui::TableSetupColumn("Live");
+    ImGui::TableSetupColumn("Peak");
+    ImGui::TableSetupColumn("Blocks");
+    if (marked) {
+        ImGui::TableSetupColumn("+Allocs");
+        ImGui::TableSetupColumn("+Live");
+    }
+    ImGui::TableHeadersRow();
+    for (int i = 0; i < kTagCount; i++) {
+        Stats stats = Get((MemoryTag)i);
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(kTagNames[i]);
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(FormatBytes(stats.liveBytes).c_str());
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(FormatBytes(stats.peakBytes).c_str());
+        ImGui::TableNextColumn();
+        ImGui::Text("%lld", (long long)(stats.allocations - stats.frees));
+        if (marked) {
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)(stats.allocations - marks[i].allocations));
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(FormatBytes(stats.liveBytes - marks[i].liveBytes).c_str());
+        }
+    }
+    ImGui::EndTable();
+}
+
+}
+
+#ifdef GAME_MEMORY_TRACKING
+
+// replacements for the global allocation functions, every form funnels into MemoryTracker::Allocate / Free
+using ClassGame::MemoryTracker;
+
+static void* TrackedNew(std::size_t size, std::size_t alignment) {
+    void* block = MemoryTracker::Allocate(size, alignment, MemoryTracker::currentTag);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void* operator new(std::size_t size) { return TrackedNew(size, 0); }
+void* operator new[](std::size_t size) { return TrackedNew(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return TrackedNew(size, (std::size_t)alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return TrackedNew(size, (std::size_t)alignment); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return MemoryTracker::Allocate(size, 0, MemoryTracker::currentTag); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return MemoryTracker::Allocate(size, 0, MemoryTracker::currentTag); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return MemoryTracker::Allocate(size, (std::size_t)alignment, MemoryTracker::currentTag);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return MemoryTracker::Allocate(size, (std::size_t)alignment, MemoryTracker::currentTag);
+}
+
+void operator delete(void* block) noexcept { MemoryTracker::Free(block); }
+void operator delete[](void* block) noexcept { MemoryTracker::Free(block); }
+void operator delete(void* block, std::size_t) noexcept { MemoryTracker::Free(block); }
+void operator delete[](void* block, std::size_t) noexcept { MemoryTracker::Free(block); }
+void operator delete(void* block, std::align_val_t) noexcept { MemoryTracker::Free(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { MemoryTracker::Free(block); }
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept { MemoryTracker::Free(block); }
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept { MemoryTracker::Free(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { MemoryTracker::Free(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { MemoryTracker::Free(block); }
+void operator delete(void* block, std::align_val_t, const std::nothrow_t&) noexcept { MemoryTracker::Free(block); }
+void operator delete[](void* block, std::align_val_t, const std::nothrow_t&) noexcept { MemoryTracker::Free(block); }
+
+#endif
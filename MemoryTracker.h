@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ClassGame {
+
+// Heap accounting per subsystem. With GAME_MEMORY_TRACKING defined (the CMake default) every operator new / delete
+// is counted against the tag of the innermost MEMORY_SCOPE on the calling thread; allocations outside any scope
+// land in General. ImGui's allocator is always counted as ImGui, and GPU textures, which the heap never sees, are
+// added by hand with RecordExternal. Counters are relaxed atomics, a tracked allocation costs a few of them.
+enum class MemoryTag : uint8_t {
+    General,
+    Game,
+    Logger,
+    ImGui,
+    Textures,
+    Sessions,
+    Network,
+    Count
+};
+
+class MemoryTracker {
+public:
+    static constexpr int kTagCount = (int)MemoryTag::Count;
+
+    struct Stats {
+        uint64_t allocations = 0;
+        uint64_t frees = 0;
+        int64_t liveBytes = 0;
+        int64_t peakBytes = 0;
+        uint64_t totalBytes = 0;   // everything ever allocated
+    };
+
+    static const char* TagName(MemoryTag tag);
+    static Stats Get(MemoryTag tag);
+    // false when built without GAME_MEMORY_TRACKING: only ImGui and textures are counted then
+    static bool IsTracking();
+
+    // memory the heap doesn't see (GPU textures), negative bytes when it is released
+    static void RecordExternal(MemoryTag tag, int64_t bytes);
+
+    // baseline for the "since mark" columns, e.g. before a batch of games to confirm resets give everything back
+    static void Mark();
+    // one line per tag with live / peak / allocation counts and the change since the last Mark
+    static std::vector<std::string> Report();
+    static void DrawPanel();
+
+    // route ImGui's allocations through the tracker, call before ImGui::CreateContext
+    static void InstallImGuiAllocator();
+
+    // the tracked heap itself; blocks carry their size and tag so Free needs neither
+    static void* Allocate(size_t size, size_t alignment, MemoryTag tag);
+    static void Free(void* block);
+
+    inline static thread_local MemoryTag currentTag = MemoryTag::General;
+};
+
+class MemoryScope {
+public:
+    explicit MemoryScope(MemoryTag tag) : previous(MemoryTracker::currentTag) { MemoryTracker::currentTag = tag; }
+    ~MemoryScope() { MemoryTracker::currentTag = previous; }
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemoryTag previous;
+};
+
+}
+
+#define MEMORY_CONCAT_INNER(a, b) a##b
+#define MEMORY_CONCAT(a, b) MEMORY_CONCAT_INNER(a, b)
+#define MEMORY_SCOPE(tag) ClassGame::MemoryScope MEMORY_CONCAT(memoryScope, __LINE__)(ClassGame::MemoryTag::tag)
@@ -0,0 +1,375 @@
+#include "Profiler.h"
+#include "imgui/imgui.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace ClassGame {
+
+Profiler::Profiler() : frames(kHistoryFrames) {
+}
+
+uint32_t Profiler::Elapsed() const {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - frameStart).count();
+    return (uint32_t)std::min<long long>(ns, UINT32_MAX);
+}
+
+void Profiler::BeginFrame() {
+    frameNumber++;
+    if (!enabled || paused) {
+        current = nullptr;
+        recording = false;
+        return;
+    }
+    current = &frames[head];
+    current->number = frameNumber;
+    current->duration = 0;
+    current->count = 0;
+    current->dropped = 0;
+    depth = 0;
+    recording = true;
+    frameStart = std::chrono::steady_clock::now();
+}
+
+void Profiler::EndFrame() {
+    if (!current) return;
+    current->duration = Elapsed();
+    // sections still open (early return past a scope's owner) end with the frame
+    while (depth > 0) {
+        Sample& sample = current->samples[stack[--depth]];
+        sample.duration = current->duration - sample.start;
+    }
+    head = (head + 1) % kHistoryFrames;
+    stored = std::min(stored + 1, kHistoryFrames);
+    current = nullptr;
+    recording = false;
+}
+
+int Profiler::BeginSection(const char* name) {
+    if (!current) return -1;
+    if (current->count >= kMaxSamples || depth >= kMaxDepth) {
+        current->dropped++;
+        return -1;
+    }
+    int index = current->count++;
+    Sample& sample = current->samples[index];
+    sample.name = name;
+    sample.start = Elapsed();
+    sample.duration = 0;
+    sample.depth = (uint16_t)depth;
+    stack[depth++] = index;
+    return index;
+}
+
+void Profiler::EndSection(int index) {
+    if (!current || depth == 0 || stack[depth - 1] != index) return;
+    Sample& sample = current->samples[index];
+    sample.duration = Elapsed() - sample.start;
+    depth--;
+}
+
+std::vector<const Profiler::Frame*> Profiler::History(int count) const {
+    count = std::clamp(count, 0, stored);
+    std::vector<const Frame*> history;
+    history.reserve((size_t)count);
+    for (int i = count; i > 0; i--) {
+        history.push_back(&frames[(head - i + kHistoryFrames) % kHistoryFrames]);
+    }
+    return history;
+}
+
+namespace {
+
+struct SectionTotals {
+    const char* name;
+    int depth;
+    uint64_t total = 0;         // ns over all frames
+    uint64_t worstFrame = 0;    // most ns spent in one frame
+    uint64_t calls = 0;
+    uint64_t thisFrame = 0;
+};
+
+// samples arrive in call order, so a section first seen in a later frame goes right after the previous sample's
+// section and the list stays in nesting order
+size_t FindSection(std::vector<SectionTotals>& sections, const char* name, int depth, size_t previous) {
+    for (size_t i = 0; i < sections.size(); i++) {
+        if (sections[i].depth == depth && (sections[i].name == name || strcmp(sections[i].name, name) == 0)) {
+            return i;
+        }
+    }
+    size_t index = previous < sections.size() ? previous + 1 : sections.size();
+    sections.insert(sections.begin() + (ptrdiff_t)index, SectionTotals{ name, depth });
+    return index;
+}
+
+std::string Format(const char* format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    return text;
+}
+
+}
+
+std::vector<std::string> Profiler::Report(int count) const {
+    std::vector<std::string> lines;
+    std::vector<const Frame*> history = History(count);
+    if (history.empty()) {
+        lines.push_back("no profiled frames yet");
+        return lines;
+    }
+
+    // sections keyed by name and depth, in call order so nesting reads top down
+    std::vector<SectionTotals> sections;
+    const Frame* slowest = history.front();
+    uint64_t frameTotal = 0;
+    for (const Frame* frame : history) {
+        frameTotal += frame->duration;
+        if (frame->duration > slowest->duration) slowest = frame;
+        for (SectionTotals& section : sections) section.thisFrame = 0;
+        size_t previous = SIZE_MAX;
+        for (int i = 0; i < frame->count; i++) {
+            const Sample& sample = frame->samples[i];
+            previous = FindSection(sections, sample.name, sample.depth, previous);
+            SectionTotals& section = sections[previous];
+            section.total += sample.duration;
+            section.thisFrame += sample.duration;
+            section.calls++;
+        }
+        for (SectionTotals& section : sections) section.worstFrame = std::max(section.worstFrame, section.thisFrame);
+    }
+
+    double frameCount = (double)history.size();
+    lines.push_back(Format("%d frames: avg %.3f ms, slowest %.3f ms (frame #%llu)", (int)history.size(),
+                           frameTotal / frameCount / 1e6, slowest->duration / 1e6, (unsigned long long)slowest->number));
+    lines.push_back(Format("%-32s %10s %10s %8s", "section", "avg ms", "max ms", "calls"));
+    for (const SectionTotals& section : sections) {
+        std::string name = std::string((size_t)section.depth * 2, ' ') + section.name;
+        lines.push_back(Format("%-32s %10.3f %10.3f %8.2f", name.c_str(), section.total / frameCount / 1e6,
+                               section.worstFrame / 1e6, section.calls / frameCount));
+    }
+
+    lines.push_back(Format("slowest frame #%llu:", (unsigned long long)slowest->number));
+    for (int i = 0; i < slowest->count; i++) {
+        const Sample& sample = slowest->samples[i];
+        std::string name = std::string((size_t)sample.depth * 2 + 2, ' ') + sample.name;
+        lines.push_back(Format("%-32s %10.3f ms at %.3f ms", name.c_str(), sample.duration / 1e6, sample.start / 1e6));
+    }
+    if (slowest->dropped) {
+        lines.push_back(Format("  (%d sections not recorded)", (int)slowest->dropped));
+    }
+    return lines;
+}
+
+void Profiler::DrawPanel() {
+    ImGui::Checkbox("Record", &enabled);
+    ImGui::SameLine();
+    ImGui::Checkbox("Pause", &paused);
+    ImGui::SameLine();
+    if (ImGui::RadioButton("Slowest", showSlowest)) showSlowest = true;
+    ImGui::SameLine();
+    if (ImGui::RadioButton("Latest", !showSlowest)) showSlowest = false;
+
+    std::vector<const Frame*> history = History();
+    if (history.empty()) {
+        ImGui::TextDisabled("no profiled frames yet");
+        return;
+    }
+
+    // frame time bars, oldest on the left
+    float values[kHistoryFrames];
+    float maxMs = 0.0f;
+    const Frame* shown = history.back();
+    for (size_t i = 0; i < history.size(); i++) {
+        values[i] = history[i]->duration / 1e6f;
+        maxMs = std::max(maxMs, values[i]);
+        if (showSlowest && history[i]->duration > shown->duration) shown = history[i];
+    }
+    char overlay[64];
+    snprintf(overlay, sizeof(overlay), "frame ms (max %.2f)", maxMs);
+    ImGui::PlotHistogram("##ProfileFrames", values, (int)history.size(), 0, overlay, 0.0f, maxMs * 1.1f, ImVec2(-1, 60));
+
+    // flame graph: one row per nesting level, widths proportional to the shown frame's duration
+    ImGui::Text("Frame #%llu: %.3f ms", (unsigned long long)shown->number, shown->duration / 1e6);
+    int rows = 1;
+    for (int i = 0; i < shown->count; i++) rows = std::max(rows, (int)shown->samples[i].depth + 1);
+    float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+    float width = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    double scale = shown->duration ? width / (double)shown->duration : 0.0;
+    for (int i = 0; i < shown->count; i++) {
+        const Sample& sample = shown->samples[i];
+        ImVec2 min(origin.x + (float)(sample.start * scale), origin.y + sample.depth * rowHeight);
+        ImVec2 max(std::max(min.x + 1.0f, origin.x + (float)((sample.start + sample.duration) * scale)), min.y + rowHeight - 1.0f);
+        unsigned int hash = 2166136261u;
+        for (const char* c = sample.name; *c; c++) hash = (hash ^ (unsigned char)*c) * 16777619u;
+        drawList->AddRectFilled(min, max, ImColor::HSV((hash % 360) / 360.0f, 0.5f, 0.75f));
+        drawList->PushClipRect(min, max, true);
+        drawList->AddText(ImVec2(min.x + 2.0f, min.y + 2.0f), IM_COL32(0, 0, 0, 255), sample.name);
+        drawList->PopClipRect();
+        if (ImGui::IsMouseHoveringRect(min, max)) {
+            ImGui::SetTooltip("%s\n%.3f ms (%.1f%% of frame)", sample.name, sample.duration / 1e6,
+                              shown->duration ? 100.0 * sample.duration / shown->duration : 0.0);
+        }
+    }
+    ImGui::Dummy(ImVec2(width, rows * rowHeight));
+}
+
+// -----------------------------------------------------------------------------
+// Tracer
+// -----------------------------------------------------------------------------
+
+namespace {
+
+// hands the calling thread's buffer back to the tracer when the thread exits
+struct BufferLease {
+    Tracer::ThreadBuffer* buffer = nullptr;
+    ~BufferLease() {
+        if (buffer) Tracer::GetInstance().Release(buffer);
+    }
+};
+
+thread_local BufferLease t_lease;
+
+void AppendJsonString(std::string& out, const char* text) {
+    out += '"';
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') out += '\\';
+        if ((unsigned char)*c < 0x20) continue;
+        out += *c;
+    }
+    out += '"';
+}
+
+}
+
+Tracer::ThreadBuffer* Tracer::LocalBuffer() {
+    if (t_lease.buffer) return t_lease.buffer;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    uint32_t current = epoch.load(std::memory_order_relaxed);
+    ThreadBuffer* buffer = nullptr;
+    // a dead thread's buffer is reusable once its events no longer belong to the current capture
+    for (auto& candidate : buffers) {
+        if (!candidate->live && candidate->epoch.load(std::memory_order_relaxed) != current) {
+            buffer = candidate.get();
+            break;
+        }
+    }
+    if (!buffer) {
+        buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = buffers.back().get();
+        buffer->tid = (int)buffers.size();
+    }
+    buffer->live = true;
+    buffer->name = "thread " + std::to_string(buffer->tid);
+    t_lease.buffer = buffer;
+    return buffer;
+}
+
+void Tracer::Release(ThreadBuffer* buffer) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer->live = false;
+}
+
+void Tracer::SetThreadName(const std::string& name) {
+    ThreadBuffer* buffer = LocalBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer->name = name;
+}
+
+void Tracer::Start() {
+    origin.store(Now(), std::memory_order_relaxed);
+    epoch.fetch_add(1, std::memory_order_release);
+    active.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::Stop() {
+    active.store(false, std::memory_order_relaxed);
+}
+
+void Tracer::Record(const char* name, uint64_t start, uint64_t end) {
+    ThreadBuffer* buffer = LocalBuffer();
+    uint32_t current = epoch.load(std::memory_order_acquire);
+    if (buffer->epoch.load(std::memory_order_relaxed) != current) {
+        // first event of a new capture on this thread: reset, then publish the epoch so Save() never pairs
+        // the new epoch with the old count
+        if (!buffer->events) buffer->events = std::make_unique<Event[]>(kEventsPerThread);
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+        buffer->epoch.store(current, std::memory_order_release);
+    }
+    size_t count = buffer->count.load(std::memory_order_relaxed);
+    if (count >= kEventsPerThread) {
+        buffer->dropped.store(buffer->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events[count] = Event{ name, start, end - start };
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+void Tracer::Counts(uint64_t& events, uint64_t& dropped, int& threads) {
+    events = dropped = 0;
+    threads = 0;
+    uint32_t current = epoch.load(std::memory_order_acquire);
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto& buffer : buffers) {
+        if (buffer->epoch.load(std::memory_order_acquire) != current) continue;
+        events += buffer->count.load(std::memory_order_acquire);
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+        threads++;
+    }
+}
+
+bool Tracer::Save(const std::string& path, std::string* error) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+
+    uint32_t current = epoch.load(std::memory_order_acquire);
+    uint64_t base = origin.load(std::memory_order_relaxed);
+    std::string out;
+    out.reserve(1 << 20);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"tictactoe\"}}";
+
+    char number[160];
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto& buffer : buffers) {
+        if (buffer->epoch.load(std::memory_order_acquire) != current) continue;
+        // events below the published count are complete; the owner keeps appending past it meanwhile
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        snprintf(number, sizeof(number), ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", buffer->tid);
+        out += number;
+        AppendJsonString(out, buffer->name.c_str());
+        out += "}}";
+        for (size_t i = 0; i < count; i++) {
+            const Event& event = buffer->events[i];
+            out += ",\n{\"name\":";
+            AppendJsonString(out, event.name);
+            double start = event.start >= base ? (event.start - base) / 1e3 : 0.0;
+            snprintf(number, sizeof(number), ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", buffer->tid, start, event.duration / 1e3);
+            out += number;
+        }
+        if (out.size() > (1 << 20)) {
+            file << out;
+            out.clear();
+        }
+    }
+    out += "\n]}\n";
+    file << out;
+    if (!file) {
+        if (error) *error = "write failed: " + path;
+        return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ClassGame {
+
+// Frame profiler: PROFILE_SCOPE("name") records a nested CPU timing into the current frame, and the last
+// kHistoryFrames frames are kept so a spike can be inspected after it happened (Game Control panel, PROFILE command).
+// The same scopes feed a Tracer capture while one is running.
+// Only the thread that called BeginFrame records; scopes on other threads (loadgen, shard workers) cost one
+// thread_local check. Frames are fixed-size, nothing is allocated while recording.
+class Profiler {
+public:
+    static Profiler& GetInstance() {
+        static Profiler instance;
+        return instance;
+    }
+
+    static constexpr int kHistoryFrames = 240;
+    static constexpr int kMaxSamples = 64;      // per frame, deeper / later scopes are counted as dropped
+    static constexpr int kMaxDepth = 16;
+
+    struct Sample {
+        const char* name;       // string literal from PROFILE_SCOPE
+        uint32_t start;         // ns from the frame start
+        uint32_t duration;      // ns
+        uint16_t depth;
+    };
+
+    struct Frame {
+        uint64_t number = 0;
+        uint32_t duration = 0;  // ns
+        uint16_t count = 0;
+        uint16_t dropped = 0;
+        Sample samples[kMaxSamples];
+    };
+
+    void BeginFrame();
+    void EndFrame();
+    int BeginSection(const char* name);
+    void EndSection(int index);
+
+    void SetEnabled(bool enable) { enabled = enable; }
+    bool IsEnabled() const { return enabled; }
+    // stop adding frames so the history can be inspected
+    void SetPaused(bool pause) { paused = pause; }
+    bool IsPaused() const { return paused; }
+
+    // oldest first, at most the last `frames` recorded frames
+    std::vector<const Frame*> History(int frames = kHistoryFrames) const;
+    // per-section average / max / calls over the last `frames` frames, plus the slowest frame broken down
+    std::vector<std::string> Report(int frames = kHistoryFrames) const;
+
+    // frame time bars plus a flame graph of the latest or slowest frame
+    void DrawPanel();
+
+    // set while the calling thread is inside BeginFrame / EndFrame
+    inline static thread_local bool recording = false;
+
+private:
+    Profiler();
+    uint32_t Elapsed() const;
+
+    std::vector<Frame> frames;
+    int head = 0;               // next slot to write
+    int stored = 0;
+    uint64_t frameNumber = 0;
+    Frame* current = nullptr;
+    std::chrono::steady_clock::time_point frameStart;
+    int stack[kMaxDepth];
+    int depth = 0;
+    bool enabled = true;
+    bool paused = false;
+    bool showSlowest = true;
+};
+
+// Chrome trace capture: between Start() and Stop() every PROFILE_SCOPE, on any thread, is also appended to a buffer
+// owned by that thread (single writer: a plain store plus a release of the count, no locks) and Save() writes
+// everything captured as trace-event JSON for chrome://tracing or Perfetto.
+// Buffers outlive their threads until the next capture starts, then get reused by new threads.
+class Tracer {
+public:
+    // never destroyed: threads that outlive static destruction (log delivery) still hand their buffers back
+    static Tracer& GetInstance() {
+        static Tracer* instance = new Tracer();
+        return *instance;
+    }
+
+    static constexpr size_t kEventsPerThread = 1 << 16;  // later events in a capture are counted as dropped
+
+    struct Event {
+        const char* name;
+        uint64_t start;         // trace clock ns
+        uint64_t duration;
+    };
+
+    void Start();
+    void Stop();
+    bool Save(const std::string& path, std::string* error = nullptr);
+    bool IsActive() const { return active.load(std::memory_order_relaxed); }
+
+    // events / dropped events / threads with events in the current capture
+    void Counts(uint64_t& events, uint64_t& dropped, int& threads);
+    // names the calling thread in exported traces
+    void SetThreadName(const std::string& name);
+
+    static uint64_t Now() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    void Record(const char* name, uint64_t start, uint64_t end);
+
+    inline static std::atomic<bool> active{ false };
+
+    struct ThreadBuffer {
+        std::unique_ptr<Event[]> events;
+        std::atomic<size_t> count{ 0 };
+        std::atomic<uint64_t> dropped{ 0 };
+        std::atomic<uint32_t> epoch{ 0 };  // capture the events belong to, published after count is reset
+        int tid = 0;
+        bool live = false;
+        std::string name;                  // guarded by registryMutex
+    };
+    void Release(ThreadBuffer* buffer);
+
+private:
+    Tracer() = default;
+    ThreadBuffer* LocalBuffer();
+
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::atomic<uint32_t> epoch{ 0 };
+    std::atomic<uint64_t> origin{ 0 };
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : name(name),
+          index(Profiler::recording ? Profiler::GetInstance().BeginSection(name) : -1),
+          traceStart(Tracer::active.load(std::memory_order_relaxed) ? Tracer::Now() : 0) {}
+    ~ProfileScope() {
+        if (index >= 0) Profiler::GetInstance().EndSection(index);
+        if (traceStart) Tracer::GetInstance().Record(name, traceStart, Tracer::Now());
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    int index;
+    uint64_t traceStart;
+};
+
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ClassGame::ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
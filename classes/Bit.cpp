@@ -1,12 +1,22 @@
 
 #include "Bit.h"
 #include "BitHolder.h"
+#include "BitPool.h"
 
 
 Bit::~Bit()
 {
 }
 
+void Bit::destroy()
+{
+	if (_pool) {
+		_pool->recycle(this);
+	} else {
+		delete this;
+	}
+}
+
 BitHolder* Bit::getHolder()
 {
 	// Look for my nearest ancestor that's a BitHolder:
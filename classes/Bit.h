@@ -4,6 +4,7 @@
 
 class Player;
 class BitHolder;
+class BitPool;
 
 //
 // these aren't used yet but will be used for dragging pieces
@@ -23,7 +24,7 @@ enum bitz
 class Bit : public Sprite
 {
 public:
-	Bit() : Sprite() { _pickedUp = false; _owner = nullptr; _gameTag = 0; };
+	Bit() : Sprite(EntityBit) { _pickedUp = false; _owner = nullptr; _gameTag = 0; _pool = nullptr; _restingZ = 0; _restingTransform = 0.0f; };
 	
 	~Bit();
 
@@ -45,7 +46,14 @@ public:
 	// move to a position
 	void		moveTo(const ImVec2 &point);
 	void		setOpacity(float opacity) { };
+
+protected:
+	// pooled bits go back to their pool instead of being deleted
+	void		destroy() override;
+
 private:
+	friend class BitPool;
+	BitPool*	_pool;
 	int			_restingZ;
 	float		_restingTransform;
 	bool		_pickedUp;
@@ -1,6 +1,7 @@
 #include "BitHolder.h"
 #include "Bit.h"
 
+// the piece reference goes with the holder, so a pooled piece is back in its pool by the time the holder is gone
 BitHolder::~BitHolder()
 {
 }
@@ -10,28 +11,24 @@ BitHolder::~BitHolder()
 //
 Bit* BitHolder::bit() const
 {
-	return _bit;
+	return _bit.get();
 }
 
 Bit* BitHolder::bit()
 {
 	if (_bit && _bit->getParent() != this && !_bit->getPickedUp())
 	{
-		_bit->release();
-		_bit = nullptr;
+		_bit.reset();
 	}
-	return _bit;
+	return _bit.get();
 }
 
 void BitHolder::setBit(Bit* abit)
 {
-	if (abit != (void *)bit()) {
+	if (abit != bit()) {
+		// the new piece is retained before the old one is released
+		_bit = EntityRef<Bit>(abit);
 		if (_bit) {
-			_bit->release();
-		}
-		_bit = abit;
-		if (_bit) {
-			_bit->retain();
 			_bit->setParent(this);
 		}
 	}
@@ -39,10 +36,7 @@ void BitHolder::setBit(Bit* abit)
 
 void BitHolder::destroyBit()
 {
-	if (_bit) {
-		_bit->release();
-		_bit = nullptr;
-	}
+	_bit.reset();
 }
 
 Bit* BitHolder::canDragBit(Bit *bit)
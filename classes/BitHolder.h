@@ -1,18 +1,17 @@
 #pragma once
 #include "Sprite.h"
-
-class Bit;
+#include "Bit.h"
 
 class BitHolder : public Sprite
 {
 public:
-	BitHolder() : Sprite() { _bit = nullptr; _gameTag = 0; };
+	BitHolder() : Sprite(EntityBitHolder) { _gameTag = 0; };
 	~BitHolder();
 
 	// current piece or nullptr if empty
 	Bit		*bit() const;
 	Bit		*bit();
-	// set the current piece
+	// set the current piece, the holder keeps a reference to it until it's replaced or destroyed
 	void	setBit(Bit* bit);
 	// destroy the current piece, triggering any associated animations
 	void	destroyBit();
@@ -21,7 +20,7 @@ public:
 	// set the gametag
 	void	setGameTag(int tag) { _gameTag = tag; };
 	// convenience function to see if the holder is empty
-	virtual bool	empty() { return _bit == nullptr; };
+	virtual bool	empty() { return !_bit; };
 
 	// can you drag this bit from this holder? if not, return a different bit to drag instead, or nullptr if not allowed
 	// cancelDragBit or draggedBitTo must be called next
@@ -49,7 +48,7 @@ public:
 	virtual void	initHolder(const ImVec2 &position, const ImVec4 &color, const char *spriteName);
 
 protected:
-	Bit		*_bit;
-	int		_gameTag;
+	EntityRef<Bit>	_bit;
+	int				_gameTag;
 };
 
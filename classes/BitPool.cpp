@@ -0,0 +1,59 @@
+#include "BitPool.h"
+#include "Bit.h"
+
+BitPool::~BitPool()
+{
+	// the owning game should have cleared its board first; anything still held is dropped with the storage
+	if (_storage) {
+		for (int i = 0; i < capacity(); i++) {
+			_storage[i]._retainCount = 0;
+		}
+	}
+}
+
+void BitPool::init(int playerCount, int bitsPerPlayer, const char *const spriteNames[])
+{
+	_playerCount = playerCount;
+	_bitsPerPlayer = bitsPerPlayer;
+	_storage = std::make_unique<Bit[]>((size_t)playerCount * bitsPerPlayer);
+	_free.assign(playerCount, std::vector<Bit*>());
+
+	for (int player = 0; player < playerCount; player++) {
+		Bit *first = &_storage[(size_t)player * bitsPerPlayer];
+		first->LoadTextureFromFile(spriteNames[player]);
+
+		_free[player].reserve(bitsPerPlayer);
+		// push in reverse so pieces are handed out in storage order
+		for (int i = bitsPerPlayer - 1; i >= 0; i--) {
+			Bit *bit = first + i;
+			bit->setTexture(first->getTexture(), first->getSize());
+			bit->_pool = this;
+			_free[player].push_back(bit);
+		}
+	}
+}
+
+Bit *BitPool::acquire(int playerNumber, Player *owner)
+{
+	std::vector<Bit*> &available = _free.at(playerNumber);
+	Bit *bit;
+	if (!available.empty()) {
+		bit = available.back();
+		available.pop_back();
+	} else {
+		Bit *prototype = &_storage[(size_t)playerNumber * _bitsPerPlayer];
+		bit = new Bit();
+		bit->setTexture(prototype->getTexture(), prototype->getSize());
+	}
+	bit->setOwner(owner);
+	return bit;
+}
+
+void BitPool::recycle(Bit *bit)
+{
+	int index = (int)(bit - _storage.get());
+	bit->setOwner(nullptr);
+	bit->setHighlighted(false);
+	bit->setPickedUp(false);
+	_free.at(index / _bitsPerPlayer).push_back(bit);
+}
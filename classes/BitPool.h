@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+class Bit;
+class Player;
+
+//
+// per-game pool of pre-constructed pieces
+// bits come back here when their last holder releases them (reset, undo, state restore),
+// so placing a piece during play never allocates or reloads a texture
+//
+class BitPool
+{
+public:
+	BitPool() : _playerCount(0), _bitsPerPlayer(0) {};
+	~BitPool();
+
+	// construct bitsPerPlayer bits for each player; spriteNames[i] is loaded once and shared by player i's bits
+	void	init(int playerCount, int bitsPerPlayer, const char *const spriteNames[]);
+	bool	initialized() const { return _storage != nullptr; }
+
+	// a free bit for the player with its owner set
+	// if the pool is exhausted a standalone bit is allocated instead
+	Bit		*acquire(int playerNumber, Player *owner);
+	// called by a pooled Bit once its last reference is released
+	void	recycle(Bit *bit);
+
+	int		available(int playerNumber) const { return (int)_free.at(playerNumber).size(); }
+	int		capacity() const { return _playerCount * _bitsPerPlayer; }
+
+private:
+	std::unique_ptr<Bit[]>			_storage;
+	std::vector<std::vector<Bit*>>	_free;
+	int								_playerCount;
+	int								_bitsPerPlayer;
+};
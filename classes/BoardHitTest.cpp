@@ -0,0 +1,98 @@
+#include "BoardHitTest.h"
+#include "Game.h"
+#include <algorithm>
+#include <cmath>
+
+void BoardHitTest::build(Game &game)
+{
+	_built = true;
+	_columns = game._gameOptions.rowX;
+	_rows = game._gameOptions.rowY;
+	_buckets.clear();
+	_regular = false;
+	if (_columns <= 0 || _rows <= 0) {
+		return;
+	}
+
+	// a regular grid is fully described by the first holder, the step to its neighbours and one size
+	BitHolder &first = game.getHolderAt(0, 0);
+	_origin = first.getPosition();
+	const ImVec2 size = first.getSize();
+	_pitch = ImVec2(_columns > 1 ? game.getHolderAt(1, 0).getPosition().x - _origin.x : size.x,
+		_rows > 1 ? game.getHolderAt(0, 1).getPosition().y - _origin.y : size.y);
+	_regular = _pitch.x > 0.0f && _pitch.y > 0.0f && _pitch.x >= size.x && _pitch.y >= size.y;
+	for (int y = 0; y < _rows && _regular; y++) {
+		for (int x = 0; x < _columns && _regular; x++) {
+			BitHolder &holder = game.getHolderAt(x, y);
+			const ImVec2 &position = holder.getPosition();
+			const ImVec2 &holderSize = holder.getSize();
+			_regular = std::fabs(position.x - (_origin.x + x * _pitch.x)) < 0.5f && std::fabs(position.y - (_origin.y + y * _pitch.y)) < 0.5f
+				&& holderSize.x == size.x && holderSize.y == size.y;
+		}
+	}
+	if (_regular) {
+		return;
+	}
+
+	_bucketSize = 1.0f;
+	for (int y = 0; y < _rows; y++) {
+		for (int x = 0; x < _columns; x++) {
+			const ImVec2 &holderSize = game.getHolderAt(x, y).getSize();
+			_bucketSize = std::max(_bucketSize, std::max(holderSize.x, holderSize.y));
+		}
+	}
+	for (int y = 0; y < _rows; y++) {
+		for (int x = 0; x < _columns; x++) {
+			BitHolder &holder = game.getHolderAt(x, y);
+			const ImVec2 &position = holder.getPosition();
+			const ImVec2 &holderSize = holder.getSize();
+			int minX = (int)std::floor(position.x / _bucketSize), maxX = (int)std::floor((position.x + holderSize.x) / _bucketSize);
+			int minY = (int)std::floor(position.y / _bucketSize), maxY = (int)std::floor((position.y + holderSize.y) / _bucketSize);
+			for (int by = minY; by <= maxY; by++) {
+				for (int bx = minX; bx <= maxX; bx++) {
+					_buckets[bucketKey(bx, by)].push_back(y * _columns + x);
+				}
+			}
+		}
+	}
+}
+
+int BoardHitTest::holderAt(Game &game, const ImVec2 &point)
+{
+	if (!_built || _columns != game._gameOptions.rowX || _rows != game._gameOptions.rowY) {
+		build(game);
+	}
+	if (_columns <= 0 || _rows <= 0) {
+		return -1;
+	}
+
+	if (_regular) {
+		int x = (int)std::floor((point.x - _origin.x) / _pitch.x);
+		int y = (int)std::floor((point.y - _origin.y) / _pitch.y);
+		// isMouseOver includes the far edge, which lands one past the last cell when holders fill the pitch
+		x = x == _columns ? _columns - 1 : x;
+		y = y == _rows ? _rows - 1 : y;
+		if (x < 0 || y < 0 || x >= _columns || y >= _rows) {
+			return -1;
+		}
+		// on an edge shared with the previous holder, that one wins, as it did when holders were scanned in order
+		if (y > 0 && game.getHolderAt(x, y - 1).isMouseOver(point)) {
+			y--;
+		}
+		if (x > 0 && game.getHolderAt(x - 1, y).isMouseOver(point)) {
+			x--;
+		}
+		return game.getHolderAt(x, y).isMouseOver(point) ? y * _columns + x : -1;
+	}
+
+	auto bucket = _buckets.find(bucketKey((int)std::floor(point.x / _bucketSize), (int)std::floor(point.y / _bucketSize)));
+	if (bucket == _buckets.end()) {
+		return -1;
+	}
+	for (int index : bucket->second) {
+		if (game.getHolderAt(index % _columns, index / _columns).isMouseOver(point)) {
+			return index;
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "../imgui/imgui.h"
+
+class Game;
+
+//
+// finds the holder under a point without testing every holder
+//
+// regular grids (holder x,y at origin + (x,y) * pitch, all the same size) are indexed directly from the grid geometry
+// anything else goes through a spatial hash of holder rects, so only the holders sharing the point's bucket are tested
+// either way the candidate is confirmed with isMouseOver, so gaps between holders still miss
+// the index is built from holder positions on first use after invalidate() (Game::startGame calls it)
+//
+class BoardHitTest
+{
+public:
+	BoardHitTest() : _built(false), _regular(false), _columns(0), _rows(0), _origin(0, 0), _pitch(0, 0), _bucketSize(1.0f) {};
+
+	// holder index (y * rowX + x) under the window-local point, or -1
+	int			holderAt(Game &game, const ImVec2 &point);
+	void		invalidate() { _built = false; }
+
+	bool		regular() const { return _regular; }
+
+private:
+	void		build(Game &game);
+	static int64_t	bucketKey(int x, int y) { return ((int64_t)x << 32) ^ (uint32_t)y; }
+
+	bool		_built;
+	bool		_regular;
+	int			_columns;
+	int			_rows;
+	ImVec2		_origin;
+	ImVec2		_pitch;
+	// irregular layouts: holder indices per bucket, buckets are the size of the largest holder
+	float		_bucketSize;
+	std::unordered_map<int64_t, std::vector<int>>	_buckets;
+};
@@ -0,0 +1,119 @@
+#include "BoardRenderer.h"
+#include "Game.h"
+#include "../Profiler.h"
+#include <algorithm>
+#include <cfloat>
+
+void BoardRenderer::rebuild(Game &game)
+{
+	PROFILE_SCOPE("rebuild board");
+
+	for (Batch &batch : _batches) {
+		batch.vertices.clear();
+		batch.indices.clear();
+	}
+	_quadCount = 0;
+	_boundsMin = ImVec2(FLT_MAX, FLT_MAX);
+	_boundsMax = ImVec2(-FLT_MAX, -FLT_MAX);
+
+	for (int y = 0; y < game._gameOptions.rowY; y++) {
+		for (int x = 0; x < game._gameOptions.rowX; x++) {
+			BitHolder &holder = game.getHolderAt(x, y);
+			addQuad(0, holder);
+			if (holder.bit()) {
+				addQuad(1, *holder.bit());
+			}
+		}
+	}
+
+	// drop batches for textures no longer on the board, keep holders below pieces
+	_batches.erase(std::remove_if(_batches.begin(), _batches.end(), [](const Batch &batch) { return batch.vertices.empty(); }), _batches.end());
+	std::stable_sort(_batches.begin(), _batches.end(), [](const Batch &a, const Batch &b) { return a.layer < b.layer; });
+	_builtVersion = game.boardVersion();
+}
+
+void BoardRenderer::addQuad(int layer, const Sprite &sprite)
+{
+	const ImVec2 &size = sprite.getSize();
+	if (size.x <= 0.0f || size.y <= 0.0f || sprite.getTexture() == 0) {
+		return;
+	}
+
+	Batch *batch = nullptr;
+	for (Batch &candidate : _batches) {
+		if (candidate.layer == layer && candidate.texture == sprite.getTexture() && candidate.vertices.size() < kMaxBatchQuads * 4) {
+			batch = &candidate;
+			break;
+		}
+	}
+	if (!batch) {
+		_batches.push_back(Batch{ layer, sprite.getTexture(), {}, {} });
+		batch = &_batches.back();
+	}
+
+	const ImVec2 &position = sprite.getPosition();
+	ImVec2 max(position.x + size.x, position.y + size.y);
+	ImU32 color = ImGui::ColorConvertFloat4ToU32(sprite.getColor());
+	ImDrawIdx base = (ImDrawIdx)batch->vertices.size();
+
+	batch->vertices.push_back(ImDrawVert{ position, ImVec2(0, 0), color });
+	batch->vertices.push_back(ImDrawVert{ ImVec2(max.x, position.y), ImVec2(1, 0), color });
+	batch->vertices.push_back(ImDrawVert{ max, ImVec2(1, 1), color });
+	batch->vertices.push_back(ImDrawVert{ ImVec2(position.x, max.y), ImVec2(0, 1), color });
+	const ImDrawIdx quad[6] = { 0, 1, 2, 0, 2, 3 };
+	for (ImDrawIdx index : quad) {
+		batch->indices.push_back((ImDrawIdx)(base + index));
+	}
+
+	_boundsMin = ImVec2(std::min(_boundsMin.x, position.x), std::min(_boundsMin.y, position.y));
+	_boundsMax = ImVec2(std::max(_boundsMax.x, max.x), std::max(_boundsMax.y, max.y));
+	_quadCount++;
+}
+
+void BoardRenderer::draw(Game &game)
+{
+	PROFILE_SCOPE("BoardRenderer::draw");
+
+	if (_builtVersion != game.boardVersion()) {
+		rebuild(game);
+	}
+	if (_quadCount == 0) {
+		return;
+	}
+
+	// same origin ImGui::SetCursorPos uses, so positions match the old per-sprite Image calls
+	ImDrawList *drawList = ImGui::GetWindowDrawList();
+	ImVec2 windowPos = ImGui::GetWindowPos();
+	ImVec2 origin(windowPos.x - ImGui::GetScrollX(), windowPos.y - ImGui::GetScrollY());
+
+	for (const Batch &batch : _batches) {
+		drawList->PushTexture(batch.texture);
+		drawList->PrimReserve((int)batch.indices.size(), (int)batch.vertices.size());
+		ImDrawIdx base = (ImDrawIdx)drawList->_VtxCurrentIdx;
+		for (const ImDrawVert &vertex : batch.vertices) {
+			ImDrawVert *out = drawList->_VtxWritePtr++;
+			*out = vertex;
+			out->pos.x += origin.x;
+			out->pos.y += origin.y;
+		}
+		for (ImDrawIdx index : batch.indices) {
+			*drawList->_IdxWritePtr++ = (ImDrawIdx)(base + index);
+		}
+		drawList->_VtxCurrentIdx += (unsigned int)batch.vertices.size();
+		drawList->PopTexture();
+	}
+
+	// hover highlight, drawn just outside the holder like the old image border
+	int hovered = game.hoveredHolder();
+	if (game.board().contains(hovered) && game.board().highlighted(hovered)) {
+		BitHolder &holder = game.getHolderAt(hovered % game._gameOptions.rowX, hovered / game._gameOptions.rowX);
+		const ImVec2 &position = holder.getPosition();
+		const ImVec2 &size = holder.getSize();
+		drawList->AddRect(ImVec2(origin.x + position.x - 1.0f, origin.y + position.y - 1.0f),
+			ImVec2(origin.x + position.x + size.x + 1.0f, origin.y + position.y + size.y + 1.0f), IM_COL32(255, 255, 0, 255));
+	}
+
+	// one item covering the board keeps the window's content size (and anything laid out after it) as before
+	ImGui::SetCursorPos(_boundsMin);
+	ImGui::Dummy(ImVec2(_boundsMax.x - _boundsMin.x, _boundsMax.y - _boundsMin.y));
+}
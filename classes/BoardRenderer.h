@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "../imgui/imgui.h"
+
+class Game;
+class Sprite;
+
+//
+// draws a game's holders and pieces straight into the current window's ImDrawList
+//
+// the quads are built once per board version, grouped into one batch per texture (holders below pieces),
+// and each frame only copies them into the draw list offset to the window position - no ImGui items per square
+// the hover highlight (Game::hoveredHolder, flagged in Game::board) is drawn on top every frame since it changes without the board changing
+//
+class BoardRenderer
+{
+public:
+	BoardRenderer() : _builtVersion(UINT64_MAX), _quadCount(0), _boundsMin(0, 0), _boundsMax(0, 0) {};
+
+	void		draw(Game &game);
+	// force a rebuild on the next draw
+	void		invalidate() { _builtVersion = UINT64_MAX; }
+
+	size_t		batchCount() const { return _batches.size(); }
+	size_t		quadCount() const { return _quadCount; }
+
+private:
+	struct Batch
+	{
+		int							layer;		// 0 holders, 1 pieces
+		ImTextureID					texture;
+		std::vector<ImDrawVert>		vertices;	// window-local positions
+		std::vector<ImDrawIdx>		indices;	// relative to the batch's first vertex
+	};
+
+	void		rebuild(Game &game);
+	void		addQuad(int layer, const Sprite &sprite);
+
+	// keeps 16-bit indices in range
+	static const size_t kMaxBatchQuads = 8192;
+
+	std::vector<Batch>	_batches;
+	uint64_t			_builtVersion;
+	size_t				_quadCount;
+	ImVec2				_boundsMin;
+	ImVec2				_boundsMax;
+};
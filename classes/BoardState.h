@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+//
+// a game's board as flat arrays indexed like the holders (y * columns + x)
+// one owner byte per cell (0 empty, 1 + playerNumber owned) and one highlight bit per cell
+//
+// rules, AI and state strings read this directly; the holders and their Bits are only a view of it
+// that Game::syncHolder brings up to date, so checking a board never walks the Sprite objects
+//
+class BoardState
+{
+public:
+	BoardState() : _columns(0), _rows(0), _emptyCount(0) {};
+
+	// resize to columns x rows and empty every cell
+	void		reset(int columns, int rows)
+	{
+		_columns = columns;
+		_rows = rows;
+		_owners.assign((size_t)columns * rows, 0);
+		_highlights.assign((_owners.size() + 63) / 64, 0);
+		_emptyCount = (int)_owners.size();
+	}
+	// empty every cell, keeping the size
+	void		clear()
+	{
+		std::fill(_owners.begin(), _owners.end(), 0);
+		std::fill(_highlights.begin(), _highlights.end(), 0);
+		_emptyCount = (int)_owners.size();
+	}
+
+	int			columns() const { return _columns; }
+	int			rows() const { return _rows; }
+	int			size() const { return (int)_owners.size(); }
+	bool		contains(int cell) const { return cell >= 0 && cell < (int)_owners.size(); }
+
+	uint8_t		owner(int cell) const { return _owners[cell]; }
+	bool		empty(int cell) const { return _owners[cell] == 0; }
+	int			emptyCount() const { return _emptyCount; }
+	const std::vector<uint8_t> &owners() const { return _owners; }
+	void		setOwner(int cell, uint8_t owner)
+	{
+		_emptyCount += (_owners[cell] != 0) - (owner != 0);
+		_owners[cell] = owner;
+	}
+
+	bool		highlighted(int cell) const { return (_highlights[cell >> 6] >> (cell & 63)) & 1; }
+	void		setHighlighted(int cell, bool highlighted)
+	{
+		uint64_t mask = 1ull << (cell & 63);
+		_highlights[cell >> 6] = highlighted ? (_highlights[cell >> 6] | mask) : (_highlights[cell >> 6] & ~mask);
+	}
+
+private:
+	int						_columns;
+	int						_rows;
+	std::vector<uint8_t>	_owners;
+	std::vector<uint64_t>	_highlights;
+	int						_emptyCount;
+};
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <string>
+#include <utility>
+
 class Entity
 {
 public:
@@ -9,14 +13,19 @@ public:
         EntityPlayer,
         EntitySprite,
         EntityBit,
-        EntityBitHolder
+        EntityBitHolder,
+        EntityTypeCount
     };
 
-    Entity() : _entityType(EntityNone), _parent(nullptr), _retainCount(0) {};
-    Entity(EntityType type) : _entityType(type) {};
+    Entity() : Entity(EntityNone) {};
+    explicit Entity(EntityType type) : _entityType(type), _parent(nullptr), _retainCount(0) { s_live[type].fetch_add(1, std::memory_order_relaxed); };
+    virtual ~Entity() { s_live[_entityType].fetch_sub(1, std::memory_order_relaxed); };
+    // a copy would share the original's parent and retain count
+    Entity(const Entity &) = delete;
+    Entity &operator=(const Entity &) = delete;
 
     EntityType getEntityType() {return _entityType; }
-    
+
     // set the parent for the Entity
     void setParent(Entity *parent) { _parent = parent; }
     // get the parent
@@ -24,19 +33,73 @@ public:
 
     // final cleanup of the entity
     void removeFromParentAndCleanup(bool cleanup) {
-        _parent = nullptr; 
+        _parent = nullptr;
         if (cleanup) {
-            delete this; 
+            destroy();
         }
     }
+    // prefer holding an EntityRef to calling these by hand
     // release the sprite from the list being drawn if count has reached zero
     void release() { _retainCount--; if (_retainCount <= 0) removeFromParentAndCleanup(true); }
     // release the sprite from the list being drawn
     void retain() { _retainCount++;}
 
+    // leak checks: entities of a type constructed and not yet destroyed, on any thread
+    static int liveCount(EntityType type) { return s_live[type].load(std::memory_order_relaxed); }
+    // "2 bits, 9 holders" for every type with live entities, empty when none are left
+    static std::string liveReport() {
+        static const char *const names[EntityTypeCount] = { "entities", "players", "sprites", "bits", "holders" };
+        std::string report;
+        for (int type = 0; type < EntityTypeCount; type++) {
+            int live = liveCount((EntityType)type);
+            if (live != 0) {
+                report += (report.empty() ? "" : ", ") + std::to_string(live) + " " + names[type];
+            }
+        }
+        return report;
+    }
+
 protected:
-    EntityType _entityType;
+    // called once the last reference is released, pooled entities override this to recycle themselves
+    virtual void destroy() { delete this; }
+
+    const EntityType _entityType;
     Entity *_parent;
     // set the retain count
     int _retainCount;
+
+private:
+    inline static std::atomic<int> s_live[EntityTypeCount];
+};
+
+//
+// owning reference to a retained entity: retains when it takes the pointer, releases when it lets go
+// the entity cleans itself up (delete or back to its pool) when the last reference is gone
+//
+template <typename T>
+class EntityRef
+{
+public:
+    EntityRef() : _entity(nullptr) {};
+    explicit EntityRef(T *entity) : _entity(entity) { if (_entity) _entity->retain(); }
+    EntityRef(const EntityRef &other) : EntityRef(other._entity) {};
+    EntityRef(EntityRef &&other) noexcept : _entity(other._entity) { other._entity = nullptr; }
+    ~EntityRef() { reset(); }
+    EntityRef &operator=(EntityRef other) noexcept { std::swap(_entity, other._entity); return *this; }
+
+    // drop this reference
+    void reset() {
+        if (_entity) {
+            T *entity = _entity;
+            _entity = nullptr;
+            entity->release();
+        }
+    }
+
+    T *get() const { return _entity; }
+    T *operator->() const { return _entity; }
+    explicit operator bool() const { return _entity != nullptr; }
+
+private:
+    T *_entity;
 };
@@ -2,7 +2,9 @@
 #include "Bit.h"
 #include "BitHolder.h"
 #include "Turn.h"
-#include "../Application.h"
+#include "GameRecord.h"
+#include "../MemoryTracker.h"
+#include "../Profiler.h"
 
 Game::Game()
 {
@@ -21,20 +23,21 @@ Game::Game()
 	_table = nullptr;
 	_winner = nullptr;
 	_lastMove = "";
+	_lastMoveSquare = -1;
+	_recorder = nullptr;
+	_turnAINodes = 0;
+	_turnAIMicros = 0;
+	_boardVersion = 0;
+	_hoveredHolder = -1;
 	_gameNumber = -1;
 }
 
 
 Game::~Game()
 {
-	for (auto & _turn : _turns) {
-		delete _turn;
-	}
 	_turns.clear();
-	for (auto & _player : _players) {
-		delete _player;
-	}
 	_players.clear();
+	_arena.reset();
 
 	_score = 0;
 	_table = nullptr;
@@ -45,10 +48,12 @@ Game::~Game()
 
 void Game::setNumberOfPlayers(unsigned int n)
 {
+	// every new board recreates the players, the old ones go with the arena in one step
 	_players.clear();
+	_arena.reset();
 	for (unsigned int i = 1; i <= n; i++)
 	{
-		Player *player = Player::initWithGame(this);
+		Player *player = Player::initWithGame(this, _arena);
 //		player->setName( std::format( "Player-{}", i ) );
 		player->setName( "Player" );
 		player->setPlayerNumber(i-1);			// player numbers are zero-based
@@ -57,9 +62,9 @@ void Game::setNumberOfPlayers(unsigned int n)
 	_winner = nullptr;
 	_gameNumber = 0;
 	_gameOptions.numberOfPlayers = n;
-	Turn *turn = Turn::initStartOfGame(this);
 	_turns.clear();
-	_turns.push_back(turn);
+	_turns.push_back(TurnRecord{ -1, 0, 0 });
+	_redoTurns.clear();
 }
 
 void Game::setAIPlayer(unsigned int playerNumber)
@@ -71,30 +76,235 @@ void Game::setAIPlayer(unsigned int playerNumber)
 
 void Game::startGame()
 {
-	std::string startState = stateString();
-	Turn *turn = _turns.at(0);
-	turn->_boardState = startState;
-	turn->_gameNumber = _gameNumber;
+	markBoardChanged();
+	// holders may have been laid out again
+	_hitTest.invalidate();
+	_hoveredHolder = -1;
+	// the board state starts from whatever setUpBoard put in the holders, from here on it leads and they follow
+	_board.reset(_gameOptions.rowX, _gameOptions.rowY);
+	for (int y = 0; y < _gameOptions.rowY; y++) {
+		for (int x = 0; x < _gameOptions.rowX; x++) {
+			BitHolder &holder = getHolderAt(x, y);
+			holder.setHighlighted(false);
+			if (holder.bit() && holder.bit()->getOwner()) {
+				_board.setOwner(y * _gameOptions.rowX + x, (uint8_t)(1 + holder.bit()->getOwner()->playerNumber()));
+			}
+		}
+	}
+	_startState = stateString();
+	_turns.reserve((size_t)_gameOptions.rowX * _gameOptions.rowY + 1);
 	_gameOptions.currentTurnNo = 0;
+	setRecorder(_recorder);
+}
+
+void Game::setRecorder(GameRecordWriter *recorder)
+{
+	_recorder = recorder;
+	if (!_recorder || !_recorder->isOpen()) {
+		return;
+	}
+	// a decided board was committed when it ended (or is a replay, or a restored session), so committing it here
+	// would write it twice; the next reset or takeback starts the record
+	if (checkForWinner() || (_turns.size() > 1 && checkForDraw())) {
+		_recorder->discardGame();
+		return;
+	}
+	_recorder->beginGame((uint32_t)_recorder->gameCount(), gameHasAI() ? 2 : 0, 0);
+	for (size_t i = 1; i < _turns.size(); i++) {
+		_recorder->recordMove(_turns[i].square, _turns[i].player, 0, 0);
+	}
 }
 
 void Game::endTurn()
 {
-	_gameOptions.currentTurnNo++;
-	std::string startState = stateString();
-	Turn *turn = new Turn;
-	turn->_boardState = stateString();
-	turn->_date = (int)_gameOptions.currentTurnNo;
-	turn->_score = _score;
-	turn->_gameNumber = _gameNumber;
+	TurnRecord turn;
+	turn.square = (int16_t)_lastMoveSquare;
+	turn.score = (int16_t)_score;
+	turn.player = (uint8_t)getCurrentPlayer()->playerNumber();
 	_turns.push_back(turn);
-	ClassGame::EndOfTurn();
+	_lastMoveSquare = -1;
+	markBoardChanged();
+
+	if (_recorder && _recorder->inGame()) {
+		_recorder->recordMove(turn.square, turn.player, _turnAINodes, _turnAIMicros);
+		Player *winner = checkForWinner();
+		if (winner) {
+			_recorder->finishGame(winner->playerNumber() == 0 ? kRecordPlayer1Win : kRecordPlayer2Win, _score);
+		} else if (checkForDraw()) {
+			_recorder->finishGame(kRecordDraw, _score);
+		}
+	}
+	_turnAINodes = 0;
+	_turnAIMicros = 0;
+
+	_gameOptions.currentTurnNo++;
+	if (_endTurnHandler) {
+		_endTurnHandler(this);
+	}
+}
+
+bool Game::applyMove(int square)
+{
+	MEMORY_SCOPE(Game);
+	if (square < 0 || square >= _gameOptions.rowX * _gameOptions.rowY) {
+		return false;
+	}
+	if (!placePieceAt(square)) {
+		return false;
+	}
+	_redoTurns.clear();
+	_lastMoveSquare = square;
+	endTurn();
+	return true;
+}
+
+bool Game::undoMove()
+{
+	MEMORY_SCOPE(Game);
+	if (!canUndo()) {
+		return false;
+	}
+	TurnRecord turn = _turns.back();
+	_turns.pop_back();
+	clearPieceAt(turn.square);
+	markBoardChanged();
+	_gameOptions.currentTurnNo--;
+	if (_recorder && _recorder->inGame()) {
+		_recorder->undoMove();
+	} else if (_recorder) {
+		// the finished game is already committed as played; the takeback continues as a new record
+		// holding the moves still on the board
+		setRecorder(_recorder);
+	}
+	_redoTurns.push_back(turn);
+	return true;
+}
+
+bool Game::redoMove()
+{
+	MEMORY_SCOPE(Game);
+	if (!canRedo()) {
+		return false;
+	}
+	TurnRecord turn = _redoTurns.back();
+	if (!placePieceAt(turn.square)) {
+		return false;
+	}
+	_redoTurns.pop_back();
+	_lastMoveSquare = turn.square;
+	endTurn();
+	return true;
+}
+
+bool Game::placePieceAt(int square)
+{
+	if (!_board.contains(square) || !_board.empty(square)) {
+		return false;
+	}
+	BitHolder &holder = getHolderAt(square % _gameOptions.rowX, square / _gameOptions.rowX);
+	if (!actionForEmptyHolder(&holder)) {
+		return false;
+	}
+	// games that place their own Bits instead of setting the owner byte
+	if (_board.empty(square) && holder.bit() && holder.bit()->getOwner()) {
+		_board.setOwner(square, (uint8_t)(1 + holder.bit()->getOwner()->playerNumber()));
+	}
+	return true;
+}
+
+void Game::clearPieceAt(int square)
+{
+	if (!_board.contains(square)) {
+		return;
+	}
+	_board.setOwner(square, 0);
+	syncHolder(square);
+}
+
+Bit* Game::pieceForPlayer(int playerNumber)
+{
+	return nullptr;
+}
+
+void Game::syncHolder(int square)
+{
+	if (!_board.contains(square)) {
+		return;
+	}
+	BitHolder &holder = getHolderAt(square % _gameOptions.rowX, square / _gameOptions.rowX);
+	int owner = _board.owner(square);
+	Bit *bit = holder.bit();
+	if (!bit && owner == 0) {
+		return;
+	}
+	if (bit && owner != 0 && bit->getOwner() && bit->getOwner()->playerNumber() == owner - 1) {
+		return;
+	}
+
+	holder.destroyBit();
+	if (owner != 0) {
+		Bit *piece = pieceForPlayer(owner - 1);
+		if (piece) {
+			piece->setPosition(holder.getPosition());
+			holder.setBit(piece);
+		}
+	}
+	markBoardChanged();
+}
+
+std::string Game::stateStringAtTurn(size_t turn) const
+{
+	std::string state = _startState;
+	for (size_t i = 1; i <= turn && i < _turns.size(); i++) {
+		const TurnRecord &record = _turns[i];
+		if (record.square >= 0 && (size_t)record.square < state.size()) {
+			state[record.square] = (char)('1' + record.player);
+		}
+	}
+	return state;
+}
+
+bool Game::restoreTurns(const std::string &startState, const std::vector<TurnRecord> &turns, const std::vector<TurnRecord> &redoTurns)
+{
+	MEMORY_SCOPE(Game);
+	size_t squares = (size_t)_gameOptions.rowX * _gameOptions.rowY;
+	if (_players.empty() || startState.size() != squares) {
+		return false;
+	}
+
+	// moves must alternate players and land on empty squares
+	std::string state = startState;
+	for (size_t i = 0; i < turns.size(); i++) {
+		const TurnRecord &turn = turns[i];
+		if (turn.square < 0 || (size_t)turn.square >= squares || state[turn.square] != '0' || turn.player != i % _players.size()) {
+			return false;
+		}
+		state[turn.square] = (char)('1' + turn.player);
+	}
+	for (const TurnRecord &turn : redoTurns) {
+		if (turn.square < 0 || (size_t)turn.square >= squares) {
+			return false;
+		}
+	}
+
+	_startState = startState;
+	_turns.resize(1);
+	_turns.insert(_turns.end(), turns.begin(), turns.end());
+	_redoTurns = redoTurns;
+	_gameOptions.currentTurnNo = (unsigned int)turns.size();
+	_score = turns.empty() ? 0 : turns.back().score;
+	_lastMoveSquare = -1;
+	setStateString(state);
+	setRecorder(_recorder);
+	return true;
 }
 
 void Game::scanForMouse()
 {
+    PROFILE_SCOPE("scanForMouse");
+
     // Don't process input or AI moves if the game is over
-    // Note: gameOver state is managed by the application layer through EndOfTurn()
+    // Note: gameOver state is managed by the application layer through its end turn handler
     // We check if there's a winner or draw to avoid further moves
     if (checkForWinner() != nullptr || checkForDraw()) {
         return;
@@ -110,22 +320,22 @@ void Game::scanForMouse()
     mousePos.x -= ImGui::GetWindowPos().x;
     mousePos.y -= ImGui::GetWindowPos().y;
 
-    for (int y=0; y<_gameOptions.rowY; y++) {
-        for (int x=0; x<_gameOptions.rowX; x++) {
-			BitHolder &holder = getHolderAt(x, y);
-            if (holder.isMouseOver(mousePos)) {
-                if (ImGui::IsMouseClicked(0)) {
-                    if (actionForEmptyHolder(&holder)) {
-                        endTurn();
-                    }
-                } else {
-                    holder.setHighlighted(true);
-                }
-            } else {
-                holder.setHighlighted(false);
-            }
+    // the hovered holder comes straight from the grid geometry, and only the old and new ones are touched
+    int hovered = _hitTest.holderAt(*this, mousePos);
+    if (hovered != _hoveredHolder) {
+        if (_board.contains(_hoveredHolder)) {
+            _board.setHighlighted(_hoveredHolder, false);
+            getHolderAt(_hoveredHolder % _gameOptions.rowX, _hoveredHolder / _gameOptions.rowX).setHighlighted(false);
         }
-    }    
+        if (_board.contains(hovered)) {
+            _board.setHighlighted(hovered, true);
+            getHolderAt(hovered % _gameOptions.rowX, hovered / _gameOptions.rowX).setHighlighted(true);
+        }
+        _hoveredHolder = hovered;
+    }
+    if (hovered >= 0 && ImGui::IsMouseClicked(0)) {
+        applyMove(hovered);
+    }
 }
 
 //
@@ -134,17 +344,13 @@ void Game::scanForMouse()
 //
 void Game::drawFrame()
 {
+    PROFILE_SCOPE("drawFrame");
+    MEMORY_SCOPE(Game);
+
     scanForMouse();
 
-    for (int y=0; y<_gameOptions.rowY; y++) {
-        for (int x=0; x<_gameOptions.rowX; x++) {
-			BitHolder &holder = getHolderAt(x, y);
-            holder.paintSprite();
-            if (holder.bit()) {
-                holder.bit()->paintSprite();
-            }
-        }
-    }
+    // quads straight into the window's draw list, rebuilt only when the board changed
+    _renderer.draw(*this);
 }
 
 void Game::bitMovedFromTo(Bit *bit, BitHolder *src, BitHolder *dst)
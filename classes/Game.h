@@ -3,13 +3,18 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <functional>
 
 #include "Player.h"
 #include "Turn.h"
 #include "Bit.h"
 #include "BitHolder.h"
+#include "BoardHitTest.h"
+#include "BoardState.h"
+#include "BoardRenderer.h"
 
 class GameTable;
+class GameRecordWriter;
 
 struct GameOptions
 {
@@ -30,7 +35,7 @@ class Game
 {
 public:
 	Game();
-	~Game();
+	virtual ~Game();
 
 	void		startGame();
 
@@ -39,8 +44,22 @@ public:
 	// draw the current frame
 	void	drawFrame();
 
+	// bumped whenever pieces are placed or removed, the renderer rebuilds its cached quads when it changes
+	// games that change holders outside of the move / state functions below must call markBoardChanged
+	uint64_t	boardVersion() const { return _boardVersion; }
+	void		markBoardChanged() { _boardVersion++; }
+
 	// end the current game turn
 	void	endTurn();
+
+	// make / unmake moves - only the affected holder is touched
+	// applyMove places the current player's piece at a holder index (y * rowX + x) and ends the turn
+	bool	applyMove(int square);
+	// take back the last turn, it can be replayed with redoMove until a new move is applied
+	bool	undoMove();
+	bool	redoMove();
+	bool	canUndo() const { return _turns.size() > 1; }
+	bool	canRedo() const { return !_redoTurns.empty(); }
 	
 	// Should return true if it is legal for the given bit to be moved from its current holder.
 	// Default implementation always returns true. 
@@ -72,6 +91,19 @@ public:
 	virtual     bool 	checkForDraw() = 0;
 	virtual		bool	animateAndPlaceBitFromTo(Bit *bit, BitHolder*src, BitHolder*dst);
 
+	// put the current player's piece on / remove the piece from a single holder
+	// the default placePieceAt goes through actionForEmptyHolder and takes the owner from the Bit it placed,
+	// clearPieceAt empties the cell and syncs the holder
+	virtual		bool	placePieceAt(int square);
+	virtual		void	clearPieceAt(int square);
+
+	// the board the rules read: owner bytes and highlight bits per holder index
+	const BoardState	&board() const { return _board; }
+	// a piece for syncHolder to put in a holder, nullptr if the game places its own Bits
+	virtual		Bit*	pieceForPlayer(int playerNumber);
+	// bring one holder's Bit in line with its owner byte (the holder is the view, _board the state)
+	void		syncHolder(int square);
+
 	virtual		void	stopGame() = 0;
     virtual     bool    gameHasAI();
     virtual     void    updateAI();
@@ -83,9 +115,32 @@ public:
 	void		setNumberOfPlayers(unsigned int playerCount);
 	void		setAIPlayer(unsigned int playerNumber);
     void        scanForMouse();
+	// holder index under the mouse as of the last scanForMouse, or -1
+	int			hoveredHolder() const { return _hoveredHolder; }
 	// function to return pointer to the [][] array of bitholders
 	virtual BitHolder &getHolderAt(const int x, const int y) = 0;
 	
+	// called at the end of every turn, after the turn is recorded (the application hooks its game-over checks here)
+	// each instance has its own, so many games can run side by side without the application layer
+	void		setEndTurnHandler(std::function<void(Game *)> handler) { _endTurnHandler = std::move(handler); }
+
+	// stream games to a record file as turns end (nullptr detaches); the game in progress is written immediately,
+	// a board that is already decided starts no record until it is reset or taken back
+	void		setRecorder(GameRecordWriter *recorder);
+	GameRecordWriter *getRecorder() const { return _recorder; }
+
+	// board state string after the given turn (0 = start of game), rebuilt from the move history
+	// assumes one character per holder: '0' empty, '1' + playerNumber owned
+	std::string					stateStringAtTurn(size_t turn) const;
+	const std::vector<TurnRecord>& getTurns() const { return _turns; }
+	const std::vector<TurnRecord>& getRedoTurns() const { return _redoTurns; }
+	const std::string&			getStartState() const { return _startState; }
+
+	// put a saved game back in one step: the board is set from the final state string instead of replaying
+	// the moves, so no turns are ended and only holders that differ are touched
+	// turns excludes the start-of-game record; returns false (and changes nothing) if the moves aren't legal
+	bool		restoreTurns(const std::string &startState, const std::vector<TurnRecord> &turns, const std::vector<TurnRecord> &redoTurns);
+
 	const unsigned int			getCurrentTurnNo() { return _gameOptions.currentTurnNo; };
 	const int					getScore() { return _score; };
 	void						setScore(int score) { _score = score; };
@@ -95,8 +150,21 @@ public:
 	GameTable				*_table;
 	Player					*_winner;
 
-	std::vector<Player*>	_players;
-	std::vector<Turn*>		_turns;
+	std::vector<Player*>	_players;			// allocated from _arena
+	GameArena				_arena;				// per-game objects, released together on every new board
+	std::vector<TurnRecord>	_turns;
+	std::vector<TurnRecord>	_redoTurns;
+	std::string				_startState;
+	int						_lastMoveSquare;	// holder index of the move being made, set by actionForEmptyHolder
+	GameRecordWriter		*_recorder;
+	std::function<void(Game *)> _endTurnHandler;
+	uint64_t				_boardVersion;
+	BoardState				_board;
+	BoardRenderer			_renderer;
+	BoardHitTest			_hitTest;
+	int						_hoveredHolder;		// the only holder scanForMouse has highlighted
+	uint32_t				_turnAINodes;		// AI search stats for the move being made, set by updateAI
+	uint32_t				_turnAIMicros;
 
 	int						_score;
 	std::string				_lastMove;
@@ -0,0 +1,236 @@
+#include "GameAnalyzer.h"
+#include "TicTacToeBitboard.h"
+#include "../Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <thread>
+
+static const char *kResultNames[4] = { "unfinished", "X wins", "O wins", "draws" };
+
+void GameStats::add(const GameRecordEntry &entry)
+{
+	games++;
+
+	// replay the moves: alternate players, empty squares only, nothing after the game ends
+	TicTacToeBitboard board;
+	int moveCount = std::min<int>(entry.moveCount, kGameRecordMaxMoves);
+	bool valid = true;
+	for (int i = 0; i < moveCount && valid; i++) {
+		int player = entry.movePlayer(i);
+		valid = player == (i & 1) && !board.gameOver() && board.play(entry.moveSquare(i), player);
+	}
+
+	int winner = board.winner();
+	GameRecordResult result = winner == 0 ? kRecordPlayer1Win : winner == 1 ? kRecordPlayer2Win : board.full() ? kRecordDraw : kRecordUnfinished;
+	if (!valid || result != entry.result) {
+		invalid++;
+		return;
+	}
+
+	moves += moveCount;
+	results[result]++;
+	lengths[moveCount]++;
+	if (moveCount > 0) {
+		openings[entry.moveSquare(0)][result]++;
+	}
+
+	EngineStats &engine = engines[entry.engineConfig];
+	engine.games++;
+	engine.moves += moveCount;
+	engine.aiNodes += entry.aiNodes;
+	engine.aiMicros += entry.aiMicros;
+	engine.results[result]++;
+}
+
+void GameStats::merge(const GameStats &other)
+{
+	games += other.games;
+	invalid += other.invalid;
+	moves += other.moves;
+	for (int r = 0; r < 4; r++) {
+		results[r] += other.results[r];
+	}
+	for (int i = 0; i <= kGameRecordMaxMoves; i++) {
+		lengths[i] += other.lengths[i];
+	}
+	for (int square = 0; square < 9; square++) {
+		for (int r = 0; r < 4; r++) {
+			openings[square][r] += other.openings[square][r];
+		}
+	}
+	for (int config = 0; config < 256; config++) {
+		EngineStats &engine = engines[config];
+		const EngineStats &theirs = other.engines[config];
+		engine.games += theirs.games;
+		engine.moves += theirs.moves;
+		engine.aiNodes += theirs.aiNodes;
+		engine.aiMicros += theirs.aiMicros;
+		for (int r = 0; r < 4; r++) {
+			engine.results[r] += theirs.results[r];
+		}
+	}
+}
+
+static std::string percent(uint64_t part, uint64_t whole)
+{
+	char text[16];
+	snprintf(text, sizeof(text), "%.1f%%", whole ? 100.0 * (double)part / (double)whole : 0.0);
+	return text;
+}
+
+std::vector<std::string> GameStats::report() const
+{
+	std::vector<std::string> lines;
+	uint64_t counted = games - invalid;
+	char line[256];
+
+	snprintf(line, sizeof(line), "%llu games (%llu invalid), average length %.2f moves",
+		(unsigned long long)games, (unsigned long long)invalid, counted ? (double)moves / (double)counted : 0.0);
+	lines.push_back(line);
+
+	std::string outcome = "Results:";
+	for (int r = 1; r < 4; r++) {
+		outcome += std::string(" ") + kResultNames[r] + " " + percent(results[r], counted);
+	}
+	lines.push_back(outcome);
+
+	for (int square = 0; square < 9; square++) {
+		const uint64_t *byResult = openings[square];
+		uint64_t total = byResult[0] + byResult[1] + byResult[2] + byResult[3];
+		if (total == 0) {
+			continue;
+		}
+		snprintf(line, sizeof(line), "Opening %d: %llu games | X %s | O %s | draw %s", square, (unsigned long long)total,
+			percent(byResult[kRecordPlayer1Win], total).c_str(), percent(byResult[kRecordPlayer2Win], total).c_str(), percent(byResult[kRecordDraw], total).c_str());
+		lines.push_back(line);
+	}
+
+	for (int config = 0; config < 256; config++) {
+		const EngineStats &engine = engines[config];
+		if (engine.games == 0) {
+			continue;
+		}
+		snprintf(line, sizeof(line), "Engine config %d: %llu games | avg length %.2f | avg AI nodes %.0f | avg AI time %.1f us | X %s | O %s | draw %s",
+			config, (unsigned long long)engine.games, (double)engine.moves / (double)engine.games,
+			(double)engine.aiNodes / (double)engine.games, (double)engine.aiMicros / (double)engine.games,
+			percent(engine.results[kRecordPlayer1Win], engine.games).c_str(), percent(engine.results[kRecordPlayer2Win], engine.games).c_str(),
+			percent(engine.results[kRecordDraw], engine.games).c_str());
+		lines.push_back(line);
+	}
+	return lines;
+}
+
+AnalyzerResult AnalyzeGameRecords(const std::vector<std::string> &paths, int threadCount)
+{
+	AnalyzerResult result;
+	auto start = std::chrono::steady_clock::now();
+
+	// map every file up front; the games of all files form one index space that is split evenly
+	std::vector<std::unique_ptr<GameRecordReader>> readers;
+	std::vector<size_t> firstGame;		// global index of each reader's first game
+	size_t totalGames = 0;
+	for (const std::string &path : paths) {
+		auto reader = std::make_unique<GameRecordReader>();
+		if (!reader->open(path)) {
+			result.errors.push_back("Cannot read record file: " + path);
+			continue;
+		}
+		firstGame.push_back(totalGames);
+		totalGames += reader->gameCount();
+		result.bytes += reader->gameCount() * sizeof(GameRecordEntry);
+		readers.push_back(std::move(reader));
+	}
+	result.files = readers.size();
+
+	if (threadCount <= 0) {
+		threadCount = (int)std::max(1u, std::thread::hardware_concurrency());
+	}
+	threadCount = (int)std::max<size_t>(1, std::min<size_t>((size_t)threadCount, totalGames / 4096 + 1));
+
+	std::vector<GameStats> partials(threadCount);
+	auto scan = [&](int worker) {
+		if (worker > 0) {
+			ClassGame::Tracer::GetInstance().SetThreadName("analyze " + std::to_string(worker));
+		}
+		PROFILE_SCOPE("analyze slice");
+		size_t begin = totalGames * worker / threadCount;
+		size_t end = totalGames * (worker + 1) / threadCount;
+		GameStats &stats = partials[worker];
+		for (size_t r = 0; r < readers.size() && begin < end; r++) {
+			size_t readerEnd = firstGame[r] + readers[r]->gameCount();
+			if (begin >= readerEnd) {
+				continue;
+			}
+			const GameRecordEntry *entries = readers[r]->entries();
+			size_t stop = std::min(end, readerEnd);
+			for (size_t i = begin; i < stop; i++) {
+				stats.add(entries[i - firstGame[r]]);
+			}
+			begin = stop;
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (int worker = 1; worker < threadCount; worker++) {
+		workers.emplace_back(scan, worker);
+	}
+	scan(0);
+	for (auto &worker : workers) {
+		worker.join();
+	}
+
+	for (const GameStats &partial : partials) {
+		result.stats.merge(partial);
+	}
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+long long GenerateSelfPlayRecords(const std::string &path, long long games, uint32_t seed)
+{
+	GameRecordWriter writer;
+	if (!writer.open(path, 3, 3)) {
+		return -1;
+	}
+
+	std::mt19937 rng(seed);
+	std::vector<GameRecordEntry> batch;
+	batch.reserve(4096);
+	long long written = 0;
+
+	for (long long game = 0; game < games; game++) {
+		GameRecordEntry entry = {};
+		entry.gameNumber = (uint32_t)(writer.gameCount() + batch.size());
+
+		TicTacToeBitboard board;
+		int player = 0;
+		while (!board.gameOver()) {
+			// pick the n-th empty square
+			uint16_t empty = board.empty();
+			int pick = (int)(rng() % (uint32_t)(9 - board.moveCount()));
+			int square = 0;
+			for (;; square++) {
+				if ((empty & (1u << square)) && pick-- == 0) {
+					break;
+				}
+			}
+			board.play(square, player);
+			entry.moves[entry.moveCount++] = (uint8_t)(square | (player << 4));
+			player ^= 1;
+		}
+		int winner = board.winner();
+		entry.result = winner == 0 ? kRecordPlayer1Win : winner == 1 ? kRecordPlayer2Win : kRecordDraw;
+
+		batch.push_back(entry);
+		if (batch.size() == batch.capacity() || game + 1 == games) {
+			if (!writer.appendGames(batch.data(), batch.size())) {
+				break;
+			}
+			written += (long long)batch.size();
+			batch.clear();
+		}
+	}
+	return written;
+}
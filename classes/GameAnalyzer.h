@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "GameRecord.h"
+
+//
+// bulk statistics over binary game records
+// each scanning thread owns one GameStats and the results are merged at the end
+//
+struct alignas(64) GameStats
+{
+	struct EngineStats
+	{
+		uint64_t	games = 0;
+		uint64_t	moves = 0;
+		uint64_t	aiNodes = 0;
+		uint64_t	aiMicros = 0;
+		uint64_t	results[4] = { 0, 0, 0, 0 };
+	};
+
+	uint64_t	games = 0;
+	uint64_t	invalid = 0;				// illegal move order or a result that doesn't match the moves
+	uint64_t	moves = 0;
+	uint64_t	results[4] = { 0, 0, 0, 0 };	// indexed by GameRecordResult
+	uint64_t	lengths[kGameRecordMaxMoves + 1] = {};
+	uint64_t	openings[9][4] = {};		// first square played -> results
+	EngineStats	engines[256];				// by GameRecordEntry::engineConfig
+
+	// decode one record with the bitboard rules and accumulate it
+	void		add(const GameRecordEntry &entry);
+	void		merge(const GameStats &other);
+	// human readable summary, one line per entry
+	std::vector<std::string> report() const;
+};
+
+struct AnalyzerResult
+{
+	GameStats	stats;
+	size_t		files = 0;
+	size_t		bytes = 0;
+	double		seconds = 0.0;
+	std::vector<std::string> errors;
+};
+
+// scan every committed game in the given files, partitioned across threadCount threads (0 = hardware threads)
+AnalyzerResult	AnalyzeGameRecords(const std::vector<std::string> &paths, int threadCount);
+
+// random-vs-random games played on bitboards, appended to a record file in batches
+// returns the number of games written, or -1 if the file can't be opened
+long long		GenerateSelfPlayRecords(const std::string &path, long long games, uint32_t seed);
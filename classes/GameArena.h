@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+//
+// per-game bump allocator for objects that live exactly as long as one game (players today)
+// create() carves objects out of a small inline buffer, spilling to the heap only if it runs out,
+// and reset() runs their destructors newest first and hands everything back in one go
+//
+// nothing is freed one at a time, so a process hosting many games doesn't churn the global heap on every reset
+//
+class GameArena
+{
+public:
+	GameArena() : _resource(_buffer, sizeof(_buffer)), _cleanups(nullptr), _bytesUsed(0), _objectCount(0) {};
+	~GameArena() { reset(); }
+	GameArena(const GameArena &) = delete;
+	GameArena &operator=(const GameArena &) = delete;
+
+	template <typename T, typename... Args>
+	T			*create(Args &&...args)
+	{
+		T *object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			_cleanups = new (allocate(sizeof(Cleanup), alignof(Cleanup))) Cleanup{ [](void *p) { static_cast<T *>(p)->~T(); }, object, _cleanups };
+		}
+		_objectCount++;
+		return object;
+	}
+
+	// raw storage, released with everything else by reset()
+	void		*allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+	{
+		_bytesUsed += size;
+		return _resource.allocate(size, alignment);
+	}
+
+	// destroy every object and rewind to the inline buffer; pointers handed out before are dead after this
+	void		reset()
+	{
+		for (Cleanup *cleanup = _cleanups; cleanup; cleanup = cleanup->next) {
+			cleanup->destroy(cleanup->object);
+		}
+		_cleanups = nullptr;
+		_resource.release();
+		_bytesUsed = 0;
+		_objectCount = 0;
+	}
+
+	size_t		bytesUsed() const { return _bytesUsed; }
+	int			objectCount() const { return _objectCount; }
+	static constexpr size_t inlineBytes() { return kInlineBytes; }
+
+private:
+	struct Cleanup
+	{
+		void		(*destroy)(void *);
+		void		*object;
+		Cleanup		*next;
+	};
+
+	// two players with their cleanup records fit with room to spare
+	static const size_t kInlineBytes = 1024;
+
+	alignas(std::max_align_t) std::byte	_buffer[kInlineBytes];	// declared before _resource, which points into it
+	std::pmr::monotonic_buffer_resource	_resource;
+	Cleanup								*_cleanups;
+	size_t								_bytesUsed;
+	int									_objectCount;
+};
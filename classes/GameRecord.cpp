@@ -0,0 +1,243 @@
+#include "GameRecord.h"
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#define recordSeek _fseeki64
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define recordSeek fseeko
+#endif
+
+static const char kRecordMagic[4] = { 'T', 'T', 'T', 'R' };
+
+//
+// writer
+//
+
+GameRecordWriter::~GameRecordWriter()
+{
+	close();
+}
+
+bool GameRecordWriter::open(const std::string &path, int rows, int columns)
+{
+	close();
+
+	_file = fopen(path.c_str(), "r+b");
+	if (_file) {
+		// existing file - validate and continue after the committed games, never append to a layout we don't write
+		if (fread(&_header, sizeof(_header), 1, _file) != 1 ||
+			memcmp(_header.magic, kRecordMagic, sizeof(kRecordMagic)) != 0 ||
+			_header.version != kGameRecordVersion ||
+			_header.entrySize != sizeof(GameRecordEntry) ||
+			_header.rows != rows || _header.columns != columns) {
+			fclose(_file);
+			_file = nullptr;
+			return false;
+		}
+	} else {
+		_file = fopen(path.c_str(), "w+b");
+		if (!_file) {
+			return false;
+		}
+		memset(&_header, 0, sizeof(_header));
+		memcpy(_header.magic, kRecordMagic, sizeof(kRecordMagic));
+		_header.version = kGameRecordVersion;
+		_header.entrySize = sizeof(GameRecordEntry);
+		_header.rows = (uint8_t)rows;
+		_header.columns = (uint8_t)columns;
+		if (!writeHeader()) {
+			close();
+			return false;
+		}
+	}
+
+	_path = path;
+	_gameCount = _header.gameCount;
+	_active = false;
+	return true;
+}
+
+void GameRecordWriter::close()
+{
+	if (_file) {
+		fclose(_file);
+		_file = nullptr;
+	}
+	_active = false;
+}
+
+void GameRecordWriter::beginGame(uint32_t gameNumber, int aiPlayer, int engineConfig)
+{
+	memset(&_entry, 0, sizeof(_entry));
+	_entry.gameNumber = gameNumber;
+	_entry.aiPlayer = (uint8_t)aiPlayer;
+	_entry.engineConfig = (uint8_t)engineConfig;
+	_entry.result = kRecordUnfinished;
+	_active = _file != nullptr;
+}
+
+void GameRecordWriter::recordMove(int square, int player, uint32_t aiNodes, uint32_t aiMicros)
+{
+	if (!_active || _entry.moveCount >= kGameRecordMaxMoves) {
+		return;
+	}
+	_entry.moves[_entry.moveCount++] = (uint8_t)((square & 0x0f) | (player << 4));
+	_entry.aiNodes += aiNodes;
+	_entry.aiMicros += aiMicros;
+	writeEntry();
+}
+
+void GameRecordWriter::undoMove()
+{
+	if (!_active || _entry.moveCount == 0) {
+		return;
+	}
+	_entry.moves[--_entry.moveCount] = 0;
+	writeEntry();
+}
+
+void GameRecordWriter::finishGame(GameRecordResult result, int score)
+{
+	if (!_active) {
+		return;
+	}
+	_entry.result = result;
+	_entry.finalScore = (int16_t)score;
+	_active = false;
+	if (writeEntry()) {
+		_gameCount++;
+		_header.gameCount = _gameCount;
+		writeHeader();
+	}
+}
+
+bool GameRecordWriter::appendGames(const GameRecordEntry *entries, size_t count)
+{
+	if (!_file || count == 0) {
+		return false;
+	}
+	int64_t offset = (int64_t)sizeof(GameRecordFileHeader) + (int64_t)_gameCount * sizeof(GameRecordEntry);
+	if (recordSeek(_file, offset, SEEK_SET) != 0 || fwrite(entries, sizeof(GameRecordEntry), count, _file) != count) {
+		return false;
+	}
+	_gameCount += count;
+	_header.gameCount = _gameCount;
+	bool ok = writeHeader();
+	// a game in progress moves to the new first free slot
+	if (_active) {
+		writeEntry();
+	}
+	return ok;
+}
+
+// the in-progress game always lives in the first uncommitted slot
+bool GameRecordWriter::writeEntry()
+{
+	int64_t offset = (int64_t)sizeof(GameRecordFileHeader) + (int64_t)_gameCount * sizeof(GameRecordEntry);
+	if (recordSeek(_file, offset, SEEK_SET) != 0) {
+		return false;
+	}
+	bool ok = fwrite(&_entry, sizeof(_entry), 1, _file) == 1;
+	fflush(_file);
+	return ok;
+}
+
+bool GameRecordWriter::writeHeader()
+{
+	if (recordSeek(_file, 0, SEEK_SET) != 0) {
+		return false;
+	}
+	bool ok = fwrite(&_header, sizeof(_header), 1, _file) == 1;
+	fflush(_file);
+	return ok;
+}
+
+//
+// reader
+//
+
+GameRecordReader::~GameRecordReader()
+{
+	close();
+}
+
+bool GameRecordReader::open(const std::string &path)
+{
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart < (LONGLONG)sizeof(GameRecordFileHeader)) {
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!mapping) {
+		return false;
+	}
+	void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view) {
+		CloseHandle(mapping);
+		return false;
+	}
+	_mapping = mapping;
+	_data = static_cast<const uint8_t *>(view);
+	_size = (size_t)size.QuadPart;
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(GameRecordFileHeader)) {
+		::close(fd);
+		return false;
+	}
+	void *view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (view == MAP_FAILED) {
+		return false;
+	}
+	madvise(view, (size_t)st.st_size, MADV_SEQUENTIAL);
+	_data = static_cast<const uint8_t *>(view);
+	_size = (size_t)st.st_size;
+#endif
+
+	const GameRecordFileHeader &fileHeader = header();
+	if (memcmp(fileHeader.magic, kRecordMagic, sizeof(kRecordMagic)) != 0 || fileHeader.version != kGameRecordVersion ||
+		fileHeader.entrySize != sizeof(GameRecordEntry)) {
+		close();
+		return false;
+	}
+	size_t slots = (_size - sizeof(GameRecordFileHeader)) / sizeof(GameRecordEntry);
+	_gameCount = fileHeader.gameCount < slots ? (size_t)fileHeader.gameCount : slots;
+	return true;
+}
+
+void GameRecordReader::close()
+{
+	if (!_data) {
+		return;
+	}
+#ifdef _WIN32
+	UnmapViewOfFile(_data);
+	CloseHandle((HANDLE)_mapping);
+#else
+	munmap(const_cast<uint8_t *>(_data), _size);
+#endif
+	_data = nullptr;
+	_mapping = nullptr;
+	_size = 0;
+	_gameCount = 0;
+}
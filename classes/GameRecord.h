@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+//
+// binary game records
+//
+// a record file is a GameRecordFileHeader followed by fixed-size GameRecordEntry slots, so game N lives at
+// sizeof(header) + N * sizeof(entry) and a reader can jump straight to it from a memory map
+//
+// the writer fills the current slot as turns end and only bumps header.gameCount once the game is over,
+// so a crash mid-game leaves a partial slot past gameCount that readers ignore
+//
+
+// bumped whenever the header or entry layout changes; readers and writers refuse any other version
+const int kGameRecordVersion = 1;
+const int kGameRecordMaxMoves = 9;
+
+enum GameRecordResult : uint8_t
+{
+	kRecordUnfinished = 0,
+	kRecordPlayer1Win = 1,
+	kRecordPlayer2Win = 2,
+	kRecordDraw = 3
+};
+
+#pragma pack(push, 1)
+struct GameRecordFileHeader
+{
+	char		magic[4];			// "TTTR"
+	uint16_t	version;
+	uint16_t	entrySize;			// sizeof(GameRecordEntry) when written
+	uint8_t		rows;
+	uint8_t		columns;
+	uint8_t		reserved[6];
+	uint64_t	gameCount;			// committed (finished) games
+	uint64_t	reserved2;
+};
+
+struct GameRecordEntry
+{
+	uint32_t	gameNumber;
+	uint8_t		moveCount;
+	uint8_t		result;				// GameRecordResult
+	uint8_t		aiPlayer;			// 0 = no AI, otherwise the AI's player number + 1
+	uint8_t		engineConfig;		// AI configuration id the game was played with
+	uint8_t		moves[kGameRecordMaxMoves];	// square in the low 4 bits, zero-based player in the high 4
+	uint8_t		reserved[3];
+	uint32_t	aiNodes;			// negamax nodes searched over the whole game
+	uint32_t	aiMicros;			// AI thinking time over the whole game
+	int16_t		finalScore;
+	uint16_t	reserved2;
+
+	int			moveSquare(int i) const { return moves[i] & 0x0f; }
+	int			movePlayer(int i) const { return moves[i] >> 4; }
+};
+#pragma pack(pop)
+
+static_assert(sizeof(GameRecordFileHeader) == 32, "record header layout changed");
+static_assert(sizeof(GameRecordEntry) == 32, "record entry layout changed");
+
+//
+// appends games to a record file one turn at a time
+//
+class GameRecordWriter
+{
+public:
+	GameRecordWriter() : _file(nullptr), _gameCount(0), _active(false), _entry() {};
+	~GameRecordWriter();
+
+	// open or create a record file, new games are appended after the committed ones
+	bool		open(const std::string &path, int rows, int columns);
+	void		close();
+	bool		isOpen() const { return _file != nullptr; }
+	const std::string &path() const { return _path; }
+	uint64_t	gameCount() const { return _gameCount; }
+
+	void		beginGame(uint32_t gameNumber, int aiPlayer, int engineConfig);
+	void		recordMove(int square, int player, uint32_t aiNodes, uint32_t aiMicros);
+	// drops the last move of the game in progress; once finishGame has committed a game it stays as played
+	// (Game starts a new record with the remaining moves when a finished game is taken back)
+	void		undoMove();
+	// commit the current game
+	void		finishGame(GameRecordResult result, int score);
+	// forget the game in progress without committing it; further moves are ignored until the next beginGame
+	void		discardGame() { _active = false; }
+	// append already finished games with a single write (bulk producers such as self-play)
+	bool		appendGames(const GameRecordEntry *entries, size_t count);
+	bool		inGame() const { return _active; }
+
+private:
+	bool		writeEntry();
+	bool		writeHeader();
+
+	FILE				*_file;
+	std::string			_path;
+	GameRecordFileHeader _header;
+	uint64_t			_gameCount;
+	bool				_active;
+	GameRecordEntry		_entry;
+};
+
+//
+// read-only, memory-mapped view of a record file
+//
+class GameRecordReader
+{
+public:
+	GameRecordReader() : _data(nullptr), _size(0), _gameCount(0), _mapping(nullptr) {};
+	~GameRecordReader();
+	GameRecordReader(const GameRecordReader &) = delete;
+	GameRecordReader &operator=(const GameRecordReader &) = delete;
+
+	bool		open(const std::string &path);
+	void		close();
+	bool		isOpen() const { return _data != nullptr; }
+
+	const GameRecordFileHeader &header() const { return *reinterpret_cast<const GameRecordFileHeader *>(_data); }
+	size_t		gameCount() const { return _gameCount; }
+	const GameRecordEntry &game(size_t index) const { return entries()[index]; }
+	const GameRecordEntry *entries() const { return reinterpret_cast<const GameRecordEntry *>(_data + sizeof(GameRecordFileHeader)); }
+
+private:
+	const uint8_t		*_data;
+	size_t				_size;
+	size_t				_gameCount;
+	void				*_mapping;		// platform mapping handle (Win32 only)
+};
@@ -0,0 +1,122 @@
+#include "PlayProtocol.h"
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <cerrno>
+
+// "unix:/path" -> sockaddr_un, otherwise [host:]port resolved for TCP
+static bool resolvePlayAddress(const std::string &address, bool passive, sockaddr_storage &storage, socklen_t &length, int &family, std::string *error)
+{
+	memset(&storage, 0, sizeof(storage));
+	if (address.rfind("unix:", 0) == 0) {
+		std::string path = address.substr(5);
+		sockaddr_un *unixAddress = reinterpret_cast<sockaddr_un *>(&storage);
+		if (path.empty() || path.size() >= sizeof(unixAddress->sun_path)) {
+			if (error) *error = "bad unix socket path: " + path;
+			return false;
+		}
+		unixAddress->sun_family = AF_UNIX;
+		memcpy(unixAddress->sun_path, path.c_str(), path.size() + 1);
+		length = sizeof(sockaddr_un);
+		family = AF_UNIX;
+		return true;
+	}
+
+	size_t colon = address.rfind(':');
+	std::string host = colon == std::string::npos ? "" : address.substr(0, colon);
+	std::string port = colon == std::string::npos ? address : address.substr(colon + 1);
+
+	addrinfo hints = {};
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = passive ? AI_PASSIVE : 0;
+	addrinfo *result = nullptr;
+	int status = getaddrinfo(host.empty() ? (passive ? nullptr : "127.0.0.1") : host.c_str(), port.c_str(), &hints, &result);
+	if (status != 0 || !result) {
+		if (error) *error = "cannot resolve " + address + ": " + gai_strerror(status);
+		return false;
+	}
+	memcpy(&storage, result->ai_addr, result->ai_addrlen);
+	length = (socklen_t)result->ai_addrlen;
+	family = result->ai_family;
+	freeaddrinfo(result);
+	return true;
+}
+
+int PlayListen(const std::string &address, std::string *error)
+{
+	sockaddr_storage storage;
+	socklen_t length;
+	int family;
+	if (!resolvePlayAddress(address, true, storage, length, family, error)) {
+		return -1;
+	}
+
+	int fd = socket(family, SOCK_STREAM, 0);
+	if (fd < 0) {
+		if (error) *error = std::string("socket: ") + strerror(errno);
+		return -1;
+	}
+	if (family == AF_UNIX) {
+		// a stale socket file from an earlier run would make bind fail
+		unlink(reinterpret_cast<sockaddr_un *>(&storage)->sun_path);
+	} else {
+		int one = 1;
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+	}
+	if (bind(fd, reinterpret_cast<sockaddr *>(&storage), length) != 0 || ::listen(fd, SOMAXCONN) != 0) {
+		if (error) *error = "cannot listen on " + address + ": " + strerror(errno);
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+int PlayConnect(const std::string &address, std::string *error)
+{
+	sockaddr_storage storage;
+	socklen_t length;
+	int family;
+	if (!resolvePlayAddress(address, false, storage, length, family, error)) {
+		return -1;
+	}
+
+	int fd = socket(family, SOCK_STREAM, 0);
+	if (fd < 0) {
+		if (error) *error = std::string("socket: ") + strerror(errno);
+		return -1;
+	}
+	if (connect(fd, reinterpret_cast<sockaddr *>(&storage), length) != 0) {
+		if (error) *error = "cannot connect to " + address + ": " + strerror(errno);
+		close(fd);
+		return -1;
+	}
+	if (family != AF_UNIX) {
+		// frames are tiny, don't let Nagle hold them back
+		int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	}
+	return fd;
+}
+
+#else
+
+int PlayListen(const std::string &address, std::string *error)
+{
+	if (error) *error = "network play is not supported on this platform";
+	return -1;
+}
+
+int PlayConnect(const std::string &address, std::string *error)
+{
+	if (error) *error = "network play is not supported on this platform";
+	return -1;
+}
+
+#endif
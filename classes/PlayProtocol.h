@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+//
+// wire protocol for network play (PlayServer / netclient)
+//
+// a connection is a stream of fixed-size frames: the client sends PlayRequestFrame, the server answers every
+// request with one PlayReplyFrame carrying the same seq, in completion order (not necessarily request order)
+// frames are sent in host byte order, the server is meant for local / same-architecture clients
+//
+
+enum PlayOp : uint8_t
+{
+	kPlayCreate = 1,		// arg = AI player (0 none, 1 X, 2 O)
+	kPlayMove = 2,			// arg = square 0-8, the AI's answer comes back in the same reply
+							// (TicTacToeBitboard::bestMove, the same search the desktop game uses)
+	kPlayQuery = 3,
+	kPlayClose = 4
+};
+
+// PlayReplyFrame::status is a SessionStatus, or this for a frame the server didn't understand
+// move / query / close on a session another connection created gets kSessionNotFound, same as an unknown id
+const uint8_t kPlayStatusBadRequest = 0xff;
+
+#pragma pack(push, 1)
+struct PlayRequestFrame
+{
+	uint8_t		op;				// PlayOp
+	int8_t		arg;
+	uint16_t	reserved;
+	uint32_t	seq;			// echoed back in the reply
+	uint64_t	session;		// SessionId, ignored for kPlayCreate
+};
+
+struct PlayReplyFrame
+{
+	uint8_t		op;
+	uint8_t		status;
+	int8_t		aiSquare;		// -1 if the AI didn't move
+	int8_t		winner;			// -1 none, otherwise the zero-based winning player
+	uint32_t	seq;
+	uint64_t	session;
+	uint16_t	cells[2];		// bitboards for X and O, bit n = square n
+	uint8_t		moveCount;
+	uint8_t		over;
+	uint16_t	reserved;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(PlayRequestFrame) == 16, "request frame layout changed");
+static_assert(sizeof(PlayReplyFrame) == 24, "reply frame layout changed");
+
+// addresses are "unix:/path/to/socket", "host:port" or just "port" (localhost)
+// both return a connected / listening socket, or -1 with the reason in error
+int		PlayListen(const std::string &address, std::string *error);
+int		PlayConnect(const std::string &address, std::string *error);
@@ -0,0 +1,387 @@
+#include "PlayServer.h"
+#include "../MemoryTracker.h"
+#include "../Profiler.h"
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#endif
+
+// epoll user data for the two fixed descriptors, client connections use their serial (from 2 up)
+static const uint64_t kListenTag = 0;
+static const uint64_t kWakeTag = 1;
+
+PlayServer::PlayServer(SessionManager &sessions) :
+	_sessions(sessions), _listenFd(-1), _epollFd(-1), _wakeFd(-1), _stopping(false), _nextSerial(2), _accepted(0), _requests(0)
+{
+}
+
+#ifdef __linux__
+
+static void setNonBlocking(int fd)
+{
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+PlayServer::~PlayServer()
+{
+	// shard threads may still be finishing requests whose callbacks reference this server
+	_sessions.flush();
+
+	for (auto &entry : _connections) {
+		close(entry.second->fd);
+	}
+	_connections.clear();
+	if (_listenFd >= 0) {
+		close(_listenFd);
+	}
+	if (_wakeFd >= 0) {
+		close(_wakeFd);
+	}
+	if (_epollFd >= 0) {
+		close(_epollFd);
+	}
+	if (!_unixPath.empty()) {
+		unlink(_unixPath.c_str());
+	}
+}
+
+bool PlayServer::listen(const std::string &address, std::string *error)
+{
+	_listenFd = PlayListen(address, error);
+	if (_listenFd < 0) {
+		return false;
+	}
+	setNonBlocking(_listenFd);
+	if (address.rfind("unix:", 0) == 0) {
+		_unixPath = address.substr(5);
+	}
+
+	_epollFd = epoll_create1(EPOLL_CLOEXEC);
+	_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (_epollFd < 0 || _wakeFd < 0) {
+		if (error) *error = std::string("epoll: ") + strerror(errno);
+		return false;
+	}
+
+	epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.u64 = kListenTag;
+	epoll_ctl(_epollFd, EPOLL_CTL_ADD, _listenFd, &event);
+	event.data.u64 = kWakeTag;
+	epoll_ctl(_epollFd, EPOLL_CTL_ADD, _wakeFd, &event);
+	return true;
+}
+
+void PlayServer::stop()
+{
+	_stopping = true;
+	if (_wakeFd >= 0) {
+		uint64_t one = 1;
+		ssize_t written = write(_wakeFd, &one, sizeof(one));
+		(void)written;
+	}
+}
+
+void PlayServer::run()
+{
+	if (_epollFd < 0) {
+		return;
+	}
+	MEMORY_SCOPE(Network);
+
+	epoll_event events[256];
+	while (!_stopping) {
+		int count = epoll_wait(_epollFd, events, 256, -1);
+		if (count < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+
+		for (int i = 0; i < count; i++) {
+			uint64_t tag = events[i].data.u64;
+			if (tag == kListenTag) {
+				acceptClients();
+				continue;
+			}
+			if (tag == kWakeTag) {
+				uint64_t value;
+				ssize_t got = read(_wakeFd, &value, sizeof(value));
+				(void)got;
+				drainCompletions();
+				continue;
+			}
+
+			// the connection may have been closed by an earlier event in this batch
+			auto found = _connections.find(tag);
+			if (found == _connections.end()) {
+				continue;
+			}
+			Connection &connection = *found->second;
+			if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+				closeClient(connection);
+				continue;
+			}
+			if ((events[i].events & EPOLLOUT) && !writeClient(connection)) {
+				continue;
+			}
+			if (events[i].events & EPOLLIN) {
+				readClient(connection);
+			}
+		}
+	}
+}
+
+void PlayServer::acceptClients()
+{
+	while (true) {
+		int fd = accept4(_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0) {
+			return;
+		}
+		int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));	// fails harmlessly on unix sockets
+
+		auto connection = std::make_unique<Connection>();
+		connection->fd = fd;
+		connection->serial = _nextSerial++;
+		connection->events = EPOLLIN;
+
+		epoll_event event = {};
+		event.events = connection->events;
+		event.data.u64 = connection->serial;
+		epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &event);
+		_connections[connection->serial] = std::move(connection);
+		_accepted++;
+	}
+}
+
+void PlayServer::readClient(Connection &connection)
+{
+	PROFILE_SCOPE("read client");
+	uint8_t buffer[16 * 1024];
+	ssize_t got = read(connection.fd, buffer, sizeof(buffer));
+	if (got == 0 || (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+		closeClient(connection);
+		return;
+	}
+	if (got < 0) {
+		return;
+	}
+
+	// whole frames straight from the read buffer, only a trailing partial frame is kept
+	const uint8_t *data = buffer;
+	size_t length = (size_t)got;
+	if (!connection.input.empty()) {
+		connection.input.insert(connection.input.end(), buffer, buffer + got);
+		data = connection.input.data();
+		length = connection.input.size();
+	}
+	size_t offset = 0;
+	for (; offset + sizeof(PlayRequestFrame) <= length; offset += sizeof(PlayRequestFrame)) {
+		PlayRequestFrame frame;
+		memcpy(&frame, data + offset, sizeof(frame));
+		handleFrame(connection, frame);
+	}
+	std::vector<uint8_t> rest(data + offset, data + length);
+	connection.input.swap(rest);
+}
+
+void PlayServer::handleFrame(Connection &connection, const PlayRequestFrame &frame)
+{
+	uint64_t serial = connection.serial;
+	uint32_t seq = frame.seq;
+	uint8_t op = frame.op;
+	auto submitted = std::chrono::steady_clock::now();
+	auto done = [this, serial, seq, op, submitted](const SessionReply &reply) {
+		Completion completion;
+		completion.serial = serial;
+		completion.submitted = submitted;
+		PlayReplyFrame &out = completion.frame;
+		memset(&out, 0, sizeof(out));
+		out.op = op;
+		out.status = reply.status;
+		out.aiSquare = reply.aiSquare;
+		out.winner = reply.winner;
+		out.seq = seq;
+		out.session = reply.id;
+		out.cells[0] = reply.cells[0];
+		out.cells[1] = reply.cells[1];
+		out.moveCount = reply.moveCount;
+		out.over = reply.over ? 1 : 0;
+
+		bool wake;
+		{
+			std::lock_guard<std::mutex> lock(_completionMutex);
+			wake = _completions.empty();
+			_completions.push_back(completion);
+		}
+		// one wakeup per batch, the loop drains everything that piled up meanwhile
+		if (wake) {
+			uint64_t one = 1;
+			ssize_t written = write(_wakeFd, &one, sizeof(one));
+			(void)written;
+		}
+	};
+
+	// answered right here, without a trip through the shards
+	auto reject = [this, &connection, &frame, seq, op](uint8_t status) {
+		PlayReplyFrame reply;
+		memset(&reply, 0, sizeof(reply));
+		reply.op = op;
+		reply.status = status;
+		reply.aiSquare = -1;
+		reply.winner = -1;
+		reply.seq = seq;
+		reply.session = frame.session;
+		queueReply(connection, reply);
+		updateEvents(connection);
+	};
+
+	// ids are predictable, so only sessions this connection created can be played, queried or closed;
+	// anyone else's look exactly like ids that don't exist
+	if (op != kPlayCreate && !connection.sessions.count(frame.session)) {
+		reject(op == kPlayMove || op == kPlayQuery || op == kPlayClose ? (uint8_t)kSessionNotFound : kPlayStatusBadRequest);
+		return;
+	}
+
+	switch (op) {
+		case kPlayCreate:	_sessions.createAsync(frame.arg, done); break;
+		case kPlayMove:		_sessions.moveAsync(frame.session, frame.arg, done); break;
+		case kPlayQuery:	_sessions.queryAsync(frame.session, done); break;
+		case kPlayClose:	_sessions.closeAsync(frame.session, done); break;
+		default:			reject(kPlayStatusBadRequest); break;
+	}
+}
+
+void PlayServer::drainCompletions()
+{
+	PROFILE_SCOPE("drain completions");
+	std::vector<Completion> batch;
+	{
+		std::lock_guard<std::mutex> lock(_completionMutex);
+		batch.swap(_completions);
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	std::vector<Connection *> touched;
+	for (const Completion &completion : batch) {
+		_serviceTimes.Record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now - completion.submitted).count());
+		_requests.fetch_add(1, std::memory_order_relaxed);
+
+		auto found = _connections.find(completion.serial);
+		if (found == _connections.end()) {
+			// client left while its game was being created
+			if (completion.frame.op == kPlayCreate && completion.frame.status == kSessionOk) {
+				_sessions.closeAsync(completion.frame.session, nullptr);
+			}
+			continue;
+		}
+		Connection &connection = *found->second;
+		if (completion.frame.status == kSessionOk) {
+			if (completion.frame.op == kPlayCreate) {
+				connection.sessions.insert(completion.frame.session);
+			} else if (completion.frame.op == kPlayClose) {
+				connection.sessions.erase(completion.frame.session);
+			}
+		}
+		if (connection.output.empty()) {
+			touched.push_back(&connection);
+		}
+		queueReply(connection, completion.frame);
+	}
+
+	// one write per connection for the whole batch
+	for (Connection *connection : touched) {
+		writeClient(*connection);
+	}
+}
+
+void PlayServer::queueReply(Connection &connection, const PlayReplyFrame &frame)
+{
+	const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&frame);
+	connection.output.insert(connection.output.end(), bytes, bytes + sizeof(frame));
+}
+
+// returns false if the connection was closed
+bool PlayServer::writeClient(Connection &connection)
+{
+	while (connection.outputSent < connection.output.size()) {
+		ssize_t sent = send(connection.fd, connection.output.data() + connection.outputSent,
+			connection.output.size() - connection.outputSent, MSG_NOSIGNAL);
+		if (sent < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				break;
+			}
+			if (errno == EINTR) {
+				continue;
+			}
+			closeClient(connection);
+			return false;
+		}
+		connection.outputSent += (size_t)sent;
+	}
+	if (connection.outputSent == connection.output.size()) {
+		connection.output.clear();
+		connection.outputSent = 0;
+	}
+	updateEvents(connection);
+	return true;
+}
+
+// read while the client keeps up with its replies, wait for writability while replies are pending
+void PlayServer::updateEvents(Connection &connection)
+{
+	size_t pending = connection.output.size() - connection.outputSent;
+	uint32_t events = (pending < kMaxPendingOutput ? (uint32_t)EPOLLIN : 0u) | (pending > 0 ? (uint32_t)EPOLLOUT : 0u);
+	if (events == connection.events) {
+		return;
+	}
+	connection.events = events;
+	epoll_event event = {};
+	event.events = events;
+	event.data.u64 = connection.serial;
+	epoll_ctl(_epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+}
+
+void PlayServer::closeClient(Connection &connection)
+{
+	for (SessionId session : connection.sessions) {
+		_sessions.closeAsync(session, nullptr);
+	}
+	epoll_ctl(_epollFd, EPOLL_CTL_DEL, connection.fd, nullptr);
+	close(connection.fd);
+	_connections.erase(connection.serial);
+}
+
+#else
+
+PlayServer::~PlayServer() {}
+
+bool PlayServer::listen(const std::string &address, std::string *error)
+{
+	if (error) *error = "network play needs epoll (Linux)";
+	return false;
+}
+
+void PlayServer::run() {}
+void PlayServer::stop() { _stopping = true; }
+void PlayServer::acceptClients() {}
+void PlayServer::readClient(Connection &connection) {}
+bool PlayServer::writeClient(Connection &connection) { return false; }
+void PlayServer::closeClient(Connection &connection) {}
+void PlayServer::updateEvents(Connection &connection) {}
+void PlayServer::handleFrame(Connection &connection, const PlayRequestFrame &frame) {}
+void PlayServer::drainCompletions() {}
+void PlayServer::queueReply(Connection &connection, const PlayReplyFrame &frame) {}
+
+#endif
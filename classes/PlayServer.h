@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "PlayProtocol.h"
+#include "SessionManager.h"
+#include "../LatencyHistogram.h"
+
+//
+// network play server
+//
+// one thread runs an epoll loop over the listening socket, every client connection (non-blocking) and an eventfd
+// requests are parsed from the byte stream and handed to the SessionManager shards; shard threads queue the
+// replies and poke the eventfd, and the loop thread writes them back, so sockets are only touched by one thread
+//
+// sessions belong to the connection that created them: other connections can't see them, and they are closed on disconnect
+// Linux only (epoll / eventfd), listen() fails elsewhere
+//
+class PlayServer
+{
+public:
+	explicit PlayServer(SessionManager &sessions);
+	~PlayServer();
+	PlayServer(const PlayServer &) = delete;
+	PlayServer &operator=(const PlayServer &) = delete;
+
+	// see PlayProtocol.h for address formats
+	bool		listen(const std::string &address, std::string *error);
+	// serve until stop(), returns immediately if listen() didn't succeed
+	void		run();
+	// safe from any thread and from a signal handler
+	void		stop();
+
+	uint64_t	requestsServed() const { return _requests.load(std::memory_order_relaxed); }
+	uint64_t	connectionsAccepted() const { return _accepted; }
+	// time from a request being parsed to its reply being queued for the socket (loop thread only)
+	const ClassGame::LatencyHistogram &serviceTimes() const { return _serviceTimes; }
+
+	// stop reading from a client that isn't draining its replies
+	static constexpr size_t kMaxPendingOutput = 256 * 1024;
+
+private:
+	struct Connection
+	{
+		int							fd = -1;
+		uint64_t					serial = 0;
+		std::vector<uint8_t>		input;
+		std::vector<uint8_t>		output;
+		size_t						outputSent = 0;
+		uint32_t					events = 0;
+		std::unordered_set<SessionId> sessions;
+	};
+
+	struct Completion
+	{
+		uint64_t					serial;
+		std::chrono::steady_clock::time_point submitted;
+		PlayReplyFrame				frame;
+	};
+
+	void		acceptClients();
+	void		readClient(Connection &connection);
+	bool		writeClient(Connection &connection);
+	void		closeClient(Connection &connection);
+	void		updateEvents(Connection &connection);
+	void		handleFrame(Connection &connection, const PlayRequestFrame &frame);
+	void		drainCompletions();
+	void		queueReply(Connection &connection, const PlayReplyFrame &frame);
+
+	SessionManager	&_sessions;
+	int				_listenFd;
+	int				_epollFd;
+	int				_wakeFd;
+	std::string		_unixPath;			// removed on shutdown
+	std::atomic<bool> _stopping;
+
+	std::unordered_map<uint64_t, std::unique_ptr<Connection>> _connections;	// by serial
+	uint64_t		_nextSerial;
+	uint64_t		_accepted;
+	std::atomic<uint64_t> _requests;
+	ClassGame::LatencyHistogram _serviceTimes;
+
+	// filled by shard threads, drained by the loop thread
+	std::mutex		_completionMutex;
+	std::vector<Completion> _completions;
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include <iostream>
 #include <map>
+#include "GameArena.h"
 
 class Game;
 
@@ -10,8 +11,8 @@ public:
 	Player() : _game(nullptr), _name(""), _extraValues(), _aiPlayer(false) {};
 	~Player() {};
 
-	static Player *initWithGame(Game *game) { Player *player = new Player(); player->_game = game; return player;}
-	static Player *initWithName(const std::string &name) { Player *player = new Player(); player->_name = name; return player;}
+	// players only come from their game's arena: freed by its reset, never deleted
+	static Player *initWithGame(Game *game, GameArena &arena) { Player *player = arena.create<Player>(); player->_game = game; return player;}
 
 	std::string		*name();
 	void			setName(const std::string &name) { _name = name; }
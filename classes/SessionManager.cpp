@@ -0,0 +1,298 @@
+#include "SessionManager.h"
+#include "../MemoryTracker.h"
+#include "../Profiler.h"
+#include <algorithm>
+#include <future>
+
+// id layout: generation (32) | slot (24) | shard (8)
+static SessionId makeSessionId(int shard, uint32_t slot, uint32_t generation)
+{
+	return ((SessionId)generation << 32) | ((SessionId)slot << 8) | (SessionId)shard;
+}
+
+static int sessionShard(SessionId id) { return (int)(id & 0xff); }
+static uint32_t sessionSlot(SessionId id) { return (uint32_t)(id >> 8) & 0xffffff; }
+static uint32_t sessionGeneration(SessionId id) { return (uint32_t)(id >> 32); }
+
+SessionManager::SessionManager(int shardCount, uint32_t maxSessionsPerShard)
+{
+	if (shardCount <= 0) {
+		shardCount = (int)std::thread::hardware_concurrency();
+	}
+	shardCount = std::min(std::max(shardCount, 1), 256);
+	maxSessionsPerShard = std::min(maxSessionsPerShard, 0xffffffu);
+
+	for (int i = 0; i < shardCount; i++) {
+		auto shard = std::make_unique<Shard>();
+		shard->index = i;
+		shard->maxSessions = maxSessionsPerShard;
+		shard->worker = std::thread(&SessionManager::workerLoop, shard.get());
+		_shards.push_back(std::move(shard));
+	}
+}
+
+SessionManager::~SessionManager()
+{
+	// pending requests are still answered before the workers exit
+	for (auto &shard : _shards) {
+		{
+			std::lock_guard<std::mutex> lock(shard->queueMutex);
+			shard->stopping = true;
+		}
+		shard->queueCv.notify_one();
+	}
+	for (auto &shard : _shards) {
+		if (shard->worker.joinable()) {
+			shard->worker.join();
+		}
+	}
+}
+
+//
+// requests
+//
+void SessionManager::createAsync(int aiPlayer, Callback callback)
+{
+	Shard &shard = *_shards[_nextShard++ % _shards.size()];
+	submit(shard, Request{ kCreate, (int8_t)aiPlayer, 0, std::move(callback) });
+}
+
+void SessionManager::moveAsync(SessionId id, int square, Callback callback)
+{
+	submit(shardFor(id), Request{ kMove, (int8_t)square, id, std::move(callback) });
+}
+
+void SessionManager::queryAsync(SessionId id, Callback callback)
+{
+	submit(shardFor(id), Request{ kQuery, 0, id, std::move(callback) });
+}
+
+void SessionManager::closeAsync(SessionId id, Callback callback)
+{
+	submit(shardFor(id), Request{ kClose, 0, id, std::move(callback) });
+}
+
+SessionReply SessionManager::create(int aiPlayer)
+{
+	return wait([&](Callback done) { createAsync(aiPlayer, std::move(done)); });
+}
+
+SessionReply SessionManager::move(SessionId id, int square)
+{
+	return wait([&](Callback done) { moveAsync(id, square, std::move(done)); });
+}
+
+SessionReply SessionManager::query(SessionId id)
+{
+	return wait([&](Callback done) { queryAsync(id, std::move(done)); });
+}
+
+SessionReply SessionManager::close(SessionId id)
+{
+	return wait([&](Callback done) { closeAsync(id, std::move(done)); });
+}
+
+// shards answer in queue order, so a marker request behind everything else is answered last
+void SessionManager::flush()
+{
+	std::mutex doneMutex;
+	std::condition_variable doneCv;
+	size_t remaining = _shards.size();
+	for (auto &shard : _shards) {
+		// generation 0 is never handed out, the query only has to come back
+		submit(*shard, Request{ kQuery, 0, makeSessionId(shard->index, 0, 0), [&](const SessionReply &) {
+			std::lock_guard<std::mutex> lock(doneMutex);
+			if (--remaining == 0) {
+				doneCv.notify_one();
+			}
+		} });
+	}
+	std::unique_lock<std::mutex> lock(doneMutex);
+	doneCv.wait(lock, [&] { return remaining == 0; });
+}
+
+size_t SessionManager::sessionCount() const
+{
+	size_t count = 0;
+	for (const auto &shard : _shards) {
+		count += shard->live.load(std::memory_order_relaxed);
+	}
+	return count;
+}
+
+size_t SessionManager::memoryUsed() const
+{
+	size_t bytes = 0;
+	for (const auto &shard : _shards) {
+		bytes += shard->capacityBytes.load(std::memory_order_relaxed);
+	}
+	return bytes;
+}
+
+SessionReply SessionManager::wait(const std::function<void(Callback)> &issue)
+{
+	std::promise<SessionReply> promise;
+	std::future<SessionReply> result = promise.get_future();
+	issue([&promise](const SessionReply &reply) { promise.set_value(reply); });
+	return result.get();
+}
+
+// ids from another shard count are routed to shard 0, which won't find them
+SessionManager::Shard &SessionManager::shardFor(SessionId id)
+{
+	size_t index = (size_t)sessionShard(id);
+	return *_shards[index < _shards.size() ? index : 0];
+}
+
+void SessionManager::submit(Shard &shard, Request request)
+{
+	{
+		std::lock_guard<std::mutex> lock(shard.queueMutex);
+		shard.queue.push_back(std::move(request));
+	}
+	shard.queueCv.notify_one();
+}
+
+//
+// worker side
+//
+void SessionManager::workerLoop(Shard *shard)
+{
+	MEMORY_SCOPE(Sessions);
+	ClassGame::Tracer::GetInstance().SetThreadName("shard " + std::to_string(shard->index));
+	std::vector<Request> batch;
+	std::unique_lock<std::mutex> lock(shard->queueMutex);
+	while (true) {
+		shard->queueCv.wait(lock, [shard] { return shard->stopping || !shard->queue.empty(); });
+		if (shard->queue.empty()) {
+			break;
+		}
+
+		batch.swap(shard->queue);
+		lock.unlock();
+		{
+			PROFILE_SCOPE("shard batch");
+			for (const Request &request : batch) {
+				SessionReply reply = handle(*shard, request);
+				if (request.callback) {
+					request.callback(reply);
+				}
+			}
+		}
+		batch.clear();
+		lock.lock();
+	}
+}
+
+GameSession *SessionManager::find(Shard &shard, SessionId id)
+{
+	uint32_t slot = sessionSlot(id);
+	if (sessionShard(id) != shard.index || slot >= shard.sessions.size()) {
+		return nullptr;
+	}
+	GameSession &session = shard.sessions[slot];
+	return session.open && session.generation == sessionGeneration(id) ? &session : nullptr;
+}
+
+SessionReply SessionManager::handle(Shard &shard, const Request &request)
+{
+	SessionReply reply;
+	reply.id = request.id;
+
+	if (request.op == kCreate) {
+		uint32_t slot;
+		if (!shard.freeSlots.empty()) {
+			slot = shard.freeSlots.back();
+			shard.freeSlots.pop_back();
+		} else if (shard.sessions.size() < shard.maxSessions) {
+			slot = (uint32_t)shard.sessions.size();
+			shard.sessions.emplace_back();
+			shard.capacityBytes = shard.sessions.capacity() * sizeof(GameSession) + shard.freeSlots.capacity() * sizeof(uint32_t);
+		} else {
+			reply.status = kSessionLimit;
+			return reply;
+		}
+
+		GameSession &session = shard.sessions[slot];
+		uint32_t generation = session.generation + 1;
+		session = GameSession();
+		session.generation = generation;
+		session.aiPlayer = (uint8_t)(request.arg == 1 || request.arg == 2 ? request.arg : 0);
+		session.open = true;
+		shard.live++;
+
+		reply.id = makeSessionId(shard.index, slot, generation);
+		reply.status = kSessionOk;
+		playAI(session, reply);
+		fillReply(session, reply);
+		return reply;
+	}
+
+	GameSession *session = find(shard, request.id);
+	if (!session) {
+		return reply;
+	}
+	reply.status = kSessionOk;
+
+	switch (request.op) {
+		case kMove: {
+			int player = session->moveCount & 1;
+			if (session->board.gameOver()) {
+				reply.status = kSessionGameOver;
+			} else if (session->aiPlayer == player + 1 || !session->board.play(request.arg, player)) {
+				reply.status = kSessionIllegalMove;
+			} else {
+				session->moves[session->moveCount++] = (uint8_t)(request.arg | (player << 4));
+				playAI(*session, reply);
+			}
+			break;
+		}
+		case kClose:
+			session->open = false;
+			shard.freeSlots.push_back(sessionSlot(request.id));
+			shard.capacityBytes = shard.sessions.capacity() * sizeof(GameSession) + shard.freeSlots.capacity() * sizeof(uint32_t);
+			shard.live--;
+			break;
+		default:
+			break;
+	}
+	fillReply(*session, reply);
+	return reply;
+}
+
+// the search result only depends on the two masks, so every session on every shard shares one table
+// (2^18 entries, -2 = not searched yet); racing writers store the same value
+static std::atomic<int8_t> s_bestMoveCache[1 << 18];
+static struct BestMoveCacheInit {
+	BestMoveCacheInit() { for (auto &entry : s_bestMoveCache) entry.store(-2, std::memory_order_relaxed); }
+} s_bestMoveCacheInit;
+
+// answer for the AI when it's on move
+void SessionManager::playAI(GameSession &session, SessionReply &reply)
+{
+	int player = session.moveCount & 1;
+	if (session.aiPlayer != player + 1 || session.board.gameOver()) {
+		return;
+	}
+	uint32_t nodes = 0;
+	std::atomic<int8_t> &cached = s_bestMoveCache[session.board.cells[0] | (session.board.cells[1] << 9)];
+	int square = cached.load(std::memory_order_relaxed);
+	if (square < 0) {
+		PROFILE_SCOPE("AI search");
+		square = session.board.bestMove(player, &nodes);
+		cached.store((int8_t)square, std::memory_order_relaxed);
+	}
+	session.board.play(square, player);
+	session.moves[session.moveCount++] = (uint8_t)(square | (player << 4));
+	session.aiNodes += nodes;
+	reply.aiSquare = (int8_t)square;
+}
+
+void SessionManager::fillReply(const GameSession &session, SessionReply &reply)
+{
+	reply.cells[0] = session.board.cells[0];
+	reply.cells[1] = session.board.cells[1];
+	reply.moveCount = session.moveCount;
+	reply.winner = (int8_t)session.board.winner();
+	reply.over = session.board.gameOver();
+}
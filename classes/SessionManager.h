@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "TicTacToeBitboard.h"
+
+//
+// hosts many independent tic tac toe games in one process
+//
+// sessions are compact bitboard games (no sprites or holders) spread over shards, each shard owns its
+// sessions and a worker thread, so a session is only ever touched by one thread and needs no locking
+//
+// ids encode the shard, the slot within it and a generation, so a closed session's id is never reused
+//
+
+typedef uint64_t SessionId;
+
+enum SessionStatus : uint8_t
+{
+	kSessionOk = 0,
+	kSessionNotFound,			// unknown or closed id
+	kSessionIllegalMove,		// square taken / out of range, or it's the AI's turn
+	kSessionGameOver,
+	kSessionLimit				// shard is full
+};
+
+struct GameSession
+{
+	TicTacToeBitboard	board;
+	uint8_t		moves[9];			// square in the low 4 bits, player in the high 4 (same as GameRecordEntry)
+	uint8_t		moveCount = 0;
+	uint8_t		aiPlayer = 0;		// 0 = no AI, otherwise the AI's player number + 1
+	bool		open = false;
+	uint32_t	generation = 0;
+	uint32_t	aiNodes = 0;		// negamax nodes searched over the whole game (0 for cached replies)
+};
+
+// snapshot returned for every request
+struct SessionReply
+{
+	SessionId		id = 0;
+	SessionStatus	status = kSessionNotFound;
+	uint16_t		cells[2] = { 0, 0 };
+	uint8_t			moveCount = 0;
+	int8_t			winner = -1;		// -1 none, otherwise the zero-based winning player
+	bool			over = false;
+	int8_t			aiSquare = -1;		// square the AI answered with, -1 if it didn't move
+
+	int				toMove() const { return moveCount & 1; }
+};
+
+class SessionManager
+{
+public:
+	using Callback = std::function<void(const SessionReply &)>;
+
+	// shardCount 0 = one shard per hardware thread
+	explicit SessionManager(int shardCount = 0, uint32_t maxSessionsPerShard = 1u << 20);
+	~SessionManager();
+	SessionManager(const SessionManager &) = delete;
+	SessionManager &operator=(const SessionManager &) = delete;
+
+	// asynchronous requests, the callback runs on the owning shard's worker thread
+	// aiPlayer: 0 = two humans, 1 = AI plays X (and opens), 2 = AI plays O
+	void			createAsync(int aiPlayer, Callback callback);
+	// the AI replies in the same request when it's its turn
+	void			moveAsync(SessionId id, int square, Callback callback);
+	void			queryAsync(SessionId id, Callback callback);
+	void			closeAsync(SessionId id, Callback callback);
+
+	// blocking versions of the above, not to be called from inside a callback
+	SessionReply	create(int aiPlayer);
+	SessionReply	move(SessionId id, int square);
+	SessionReply	query(SessionId id);
+	SessionReply	close(SessionId id);
+
+	// block until every request submitted so far has been answered
+	void			flush();
+
+	size_t			shardCount() const { return _shards.size(); }
+	size_t			sessionCount() const;
+	// session storage in bytes, including free slots
+	size_t			memoryUsed() const;
+
+private:
+	enum RequestOp : uint8_t { kCreate, kMove, kQuery, kClose };
+
+	struct Request
+	{
+		RequestOp	op;
+		int8_t		arg;			// aiPlayer for create, square for move
+		SessionId	id;
+		Callback	callback;
+	};
+
+	struct Shard
+	{
+		int							index = 0;
+		uint32_t					maxSessions = 0;
+		std::thread					worker;
+		std::mutex					queueMutex;
+		std::condition_variable		queueCv;
+		std::vector<Request>		queue;
+		bool						stopping = false;
+
+		// owned by the worker thread
+		std::vector<GameSession>	sessions;
+		std::vector<uint32_t>		freeSlots;
+		std::atomic<size_t>			live{ 0 };
+		std::atomic<size_t>			capacityBytes{ 0 };
+	};
+
+	void			submit(Shard &shard, Request request);
+	Shard		   &shardFor(SessionId id);
+	SessionReply	wait(const std::function<void(Callback)> &issue);
+
+	static void		workerLoop(Shard *shard);
+	static SessionReply	handle(Shard &shard, const Request &request);
+	static GameSession *find(Shard &shard, SessionId id);
+	static void		playAI(GameSession &session, SessionReply &reply);
+	static void		fillReply(const GameSession &session, SessionReply &reply);
+
+	std::vector<std::unique_ptr<Shard>> _shards;
+	std::atomic<uint32_t>	_nextShard{ 0 };
+};
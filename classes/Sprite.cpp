@@ -1,12 +1,35 @@
 #include "Sprite.h"
+#include "../MemoryTracker.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include <iostream>
 #include <filesystem>
+#include <string>
+#include <unordered_map>
+
+// textures already uploaded, keyed by resource filename
+struct CachedTexture
+{
+    ImTextureID texture;
+    ImVec2      size;
+};
+static std::unordered_map<std::string, CachedTexture> s_textureCache;
 
 // Simple helper function to load an image into a OpenGL texture with common settings
 bool Sprite::LoadTextureFromFile(const char* filename)
 {
+#ifdef GAME_HEADLESS
+    // no renderer in headless builds, sprites only carry game state
+    (void)filename;
+    return true;
+#else
+    auto cached = s_textureCache.find(filename);
+    if (cached != s_textureCache.end()) {
+        _texture = cached->second.texture;
+        _size = cached->second.size;
+        return true;
+    }
+
     // Load from file
     int image_width = 0;
     int image_height = 0;
@@ -25,7 +48,11 @@ bool Sprite::LoadTextureFromFile(const char* filename)
         return false;
     }
     _size = ImVec2((float)image_width, (float)image_height);
+    s_textureCache[filename] = CachedTexture{ _texture, _size };
+    // RGBA8 on the GPU, uploaded once and kept for the life of the process
+    ClassGame::MemoryTracker::RecordExternal(ClassGame::MemoryTag::Textures, (int64_t)image_width * image_height * 4);
     return true;
+#endif
 }
 
 void Sprite::setHighlighted(bool highlighted)
@@ -40,7 +67,14 @@ bool Sprite::highlighted()
 	return _highlighted;
 }
 
-#ifdef __APPLE__
+#if defined(GAME_HEADLESS)
+
+ImTextureID Sprite::_loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height)
+{
+    return 0;
+}
+
+#elif defined(__APPLE__)
 #include "../imgui/imgui_impl_opengl3_loader.h"
 
 ImTextureID Sprite::_loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height)
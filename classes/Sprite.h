@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include "Entity.h"
 #include "../imgui/imgui.h"
 
@@ -8,19 +9,19 @@ class Sprite : public Entity
     // it is not intended to be a full-featured sprite class, but rather a simple one that can be used for simple games
 
 public:
-    Sprite() : 
-        _parent(nullptr),
+    explicit Sprite(EntityType type = EntitySprite) :
+        Entity(type),
         _location(0, 0),
         _size(0,0),
         _rotation(0), 
         _scale(1),
         _color(1, 1, 1, 1),
         _localZOrder(0),
+        _texture(0),
         _highlighted(false)
-        { 
-            _entityType = EntitySprite;
-        };
-    ~Sprite() { if (_retainCount > 0) release(); }
+        {};
+    // whoever still holds a reference (EntityRef) owns the release, destruction never triggers one
+    ~Sprite() {}
     
     // set the texture to use for this sprite
     void setPosition(float x, float y)
@@ -31,7 +32,7 @@ public:
     {
         _location = point;
     }
-    const ImVec2 &getPosition() { return _location; }
+    const ImVec2 &getPosition() const { return _location; }
 
     void setSize(float x, float y)
     {
@@ -46,6 +47,7 @@ public:
     {
         _color = ImVec4(r, g, b, a);
     }
+    const ImVec4 &getColor() const { return _color; }
     // set my Z order
     void setLocalZOrder(int localZOrder) { _localZOrder = localZOrder; }
     // get my Z order
@@ -70,7 +72,12 @@ public:
         return (mousePos.x >= _location.x && mousePos.x <= _location.x + _size.x && mousePos.y >= _location.y && mousePos.y <= _location.y + _size.y);
     }
 
+    // textures are cached by filename, so repeated loads share one GPU texture
     bool LoadTextureFromFile(const char* filename);
+    // share an already loaded texture
+    void setTexture(ImTextureID texture, const ImVec2 &size) { _texture = texture; _size = size; }
+    ImTextureID getTexture() const { return _texture; }
+    const ImVec2 &getSize() const { return _size; }
 	
     // set the highlighted state
 	void	setHighlighted(bool yes);
@@ -81,8 +88,6 @@ public:
 private:
     // the texture to use for this sprite
     // GLuint _texture;
-    // the parent of this sprite
-    Sprite *_parent;
     // the position of the sprite
     ImVec2  _location;
     // the size of the sprite
@@ -1,4 +1,8 @@
 #include "TicTacToe.h"
+#include "../MemoryTracker.h"
+#include "../Profiler.h"
+#include <algorithm>
+#include <chrono>
 
 // -----------------------------------------------------------------------------
 // TicTacToe.cpp
@@ -20,13 +24,11 @@
 //  - Game options     : let the mouse know the grid is 3x3 (rowX, rowY)
 //  - Helpers you’ll see used: setNumberOfPlayers, getPlayerAt, startGame, etc.
 //
-// I’ve already fully implemented PieceForPlayer() for you. Please leave that as‑is.
+// The rules read the owner bytes in Game::board(); the Squares and their Bits are synced from it.
+// pieceForPlayer() hands out pieces from the per-game BitPool, so play never allocates.
 // The rest of the routines are written as “comment-first” TODOs for you to complete.
 // -----------------------------------------------------------------------------
 
-const int AI_PLAYER   = 1;      // AI player (O) - player 2
-const int HUMAN_PLAYER= -1;      // human player (X) - player 1
-
 // Winning combinations for tic-tac-toe (indices 0-8)
 const int WINNING_COMBOS[8][3] = {
     {0, 1, 2},  // top row
@@ -41,29 +43,37 @@ const int WINNING_COMBOS[8][3] = {
 
 TicTacToe::TicTacToe()
 {
+    _lastAIChoice = -1;
+    _aiNodes = 0;
 }
 
 TicTacToe::~TicTacToe()
 {
+    // hand every piece back to the pool before it goes away
+    stopGame();
 }
 
 // -----------------------------------------------------------------------------
 // make an X or an O
 // -----------------------------------------------------------------------------
-// DO NOT CHANGE: This returns a new Bit with the right texture and owner
-Bit* TicTacToe::PieceForPlayer(const int playerNumber) {
-    Bit *bit = new Bit();
-    bit->LoadTextureFromFile(playerNumber == 1 ? "o.png" : "x.png");
-    bit->setOwner(getPlayerAt(playerNumber));
-    return bit;
+// This returns a pooled Bit with the right texture and owner, syncHolder puts it in place
+Bit* TicTacToe::pieceForPlayer(int playerNumber) {
+    return _bitPool.acquire(playerNumber, getPlayerAt(playerNumber));
 }
 
 //
 // setup the game board, this is called once at the start of the game
 //
 void TicTacToe::setUpBoard() {
+    MEMORY_SCOPE(Game);
     // set number of players to 2
     setNumberOfPlayers(2);
+
+    // one piece per square for each player, textures loaded once
+    if (!_bitPool.initialized()) {
+        const char *pieceSprites[2] = { "x.png", "o.png" };
+        _bitPool.init(2, 9, pieceSprites);
+    }
     
     // set _gameOptions.rowX and rowY to 3
     _gameOptions.rowX = 3;
@@ -92,13 +102,13 @@ bool TicTacToe::actionForEmptyHolder(BitHolder *holder) {
     if (!holder) return false;
 
     // Step 2: Check if empty
-    if (holder->bit() != nullptr) return false;
+    int square = (int)(static_cast<Square*>(holder) - &_grid[0][0]);
+    if (!_board.contains(square) || !_board.empty(square)) return false;
 
-    // Step 3: Place current player's piece
-    int currentPlayerIndex = getCurrentPlayer()->playerNumber();
-    Bit* newBit = PieceForPlayer(currentPlayerIndex);
-    newBit->setPosition(holder->getPosition());
-    holder->setBit(newBit);
+    // Step 3: Claim the square for the current player, the holder gets its piece from the board
+    _board.setOwner(square, (uint8_t)(1 + getCurrentPlayer()->playerNumber()));
+    syncHolder(square);
+    _lastMoveSquare = square;
     
     // Step 4: Return true to indicate successful placement
     return true;
@@ -118,31 +128,27 @@ bool TicTacToe::canBitMoveFromTo(Bit* bit, BitHolder*src, BitHolder*dst) {
 // free all the memory used by the game on the heap
 //
 void TicTacToe::stopGame() {
+    MEMORY_SCOPE(Game);
     // clear out the board
-    // loop through the 3x3 array and call destroyBit on each square
+    // empty the owner bytes, then loop through the 3x3 array and call destroyBit on each square
+    _board.clear();
     for (int y = 0; y < 3; y++) {
         for (int x = 0; x < 3; x++) {
             _grid[y][x].destroyBit();
         }
     }
+    markBoardChanged();
 }
 
 //
 // helper function for the winner check
 //
 Player* TicTacToe::ownerAt(int index) const {
-    // index is 0..8, convert to x,y
-    int y = index / 3;
-    int x = index % 3;
+    // index is 0..8, straight into the owner bytes
+    int owner = _board.contains(index) ? _board.owner(index) : 0;
     
-    // if there is no bit at that location return nullptr
-    Bit* bit = _grid[y][x].bit();
-    if (!bit) {
-        return nullptr;
-    }
-    
-    // otherwise return the owner of the bit at that location
-    return bit->getOwner();
+    // if nobody owns that square return nullptr, otherwise the owning player
+    return owner ? _players.at(owner - 1) : nullptr;
 }
 
 Player* TicTacToe::checkForWinner() {
@@ -167,18 +173,8 @@ bool TicTacToe::checkForDraw() {
         return false;
     }
     
-    // check if board is full
-    for (int y = 0; y < 3; y++) {
-        for (int x = 0; x < 3; x++) {
-            // if any square is empty, it's not a draw yet
-            if (_grid[y][x].bit() == nullptr) {
-                return false;
-            }
-        }
-    }
-    
-    // board is full with no winner
-    return true;
+    // board is full with no winner (a board that was never set up has no squares yet)
+    return _board.size() == 9 && _board.emptyCount() == 0;
 }
 
 //
@@ -189,159 +185,115 @@ std::string TicTacToe::initialStateString() {
 }
 
 //
-// this still needs to be tied into imguis init and shutdown
-// we will read the state string and store it in each turn object
+// the board as one '0' / '1' / '2' char per square, saved to the imgui ini file on shutdown (see Application.cpp)
 //
-std::string TicTacToe::stateString() const {
-    std::string currentState = "";
+TicTacToe::StateArray TicTacToe::stateArray() const {
+    StateArray state;
     
-    // for each bit in the grid
-    for (int y = 0; y < 3; y++) {
-        for (int x = 0; x < 3; x++) {
-            Bit* bit = _grid[y][x].bit();
-            
-            // if bit exists
-            if (bit != nullptr) {
-                // get the owner's player number and add 1 (to make it 1 or 2)
-                int playerNum = bit->getOwner()->playerNumber() + 1;
-                currentState += std::to_string(playerNum);
-            } else {
-                // empty square
-                currentState += "0";
-            }
-        }
+    // owner byte per square: owner's player number + 1 (1 or 2), or 0 for an empty square
+    for (int index = 0; index < 9; index++) {
+        state[index] = (char)('0' + (_board.contains(index) ? _board.owner(index) : 0));
     }
     
-    return currentState;
+    return state;
 }
 
-//
-// this still needs to be tied into imguis init and shutdown
-// when the program starts it will load the current game from the imgui ini file and set the game state to the last saved state
-//
-void TicTacToe::setStateString(const std::string &s) {
-    // loop through the string and set each square
+// 9 chars fits the small-string buffer, so this doesn't allocate
+std::string TicTacToe::stateString() const {
+    StateArray state = stateArray();
+    return std::string(state.data(), state.size());
+}
+
+uint32_t TicTacToe::packedState() const {
+    StateArray state = stateArray();
+    uint32_t packed = 0;
     for (int index = 0; index < 9; index++) {
-        char c = s[index];
-        int playerNumber = c - '0';
-        
-        // convert index to x,y coordinates
-        int y = index / 3;
-        int x = index % 3;
-        
-        if (playerNumber == 1) {
-            // create piece for player 1 (X)
-            Bit* piece = PieceForPlayer(0);
-            piece->setPosition(_grid[y][x].getPosition());
-            _grid[y][x].setBit(piece);
-        } else if (playerNumber == 2) {
-            // create piece for player 2 (O)
-            Bit* piece = PieceForPlayer(1);
-            piece->setPosition(_grid[y][x].getPosition());
-            _grid[y][x].setBit(piece);
-        } else {
-            // playerNumber is 0, so leave empty
-            _grid[y][x].setBit(nullptr);
-        }
+        packed |= (uint32_t)(state[index] - '0') << (index * 2);
     }
+    return packed;
 }
 
 //
-// this is the function that will be called by the AI
+// set the board from a state, only squares whose owner changes are synced (cleared or refilled from the piece pool)
+// this is how a saved game is restored at startup, so no textures are loaded per square
 //
-void TicTacToe::updateAI() {
-    std::string currentState = stateString();
-    int bestMove = -10000;
-    int bestSquare = -1;
-    
-    _lastAIEvaluations.clear();
-    _lastAIChoice = -1;
-    
-    // Try each empty square
-    for (int i = 0; i < 9; i++) {
-        if (currentState[i] == '0') {
-            // Make AI move (player 2)
-            currentState[i] = '2';
-            int evaluation = -negamax(currentState, 0, -10000, 10000, HUMAN_PLAYER);
+void TicTacToe::setStateArray(const StateArray &state) {
+    if (_board.size() != 9) {
+        return;
+    }
+    markBoardChanged();
 
-            // Undo move
-            currentState[i] = '0';
-            // Track evaluation for debugging
-            _lastAIEvaluations.push_back({i, evaluation});
+    for (int index = 0; index < 9; index++) {
+        // anything but player 1 (X) or player 2 (O) is an empty square
+        int owner = state[index] - '0';
+        if (owner != 1 && owner != 2) {
+            owner = 0;
+        }
 
-            // Update best move
-            if (evaluation > bestMove) {
-                bestMove = evaluation;
-                bestSquare = i;
-            }
+        // leave squares that already match alone
+        if (_board.owner(index) == owner) {
+            continue;
         }
-    }
-    
-    // Make the best move
-    if (bestSquare != -1) {
-        _lastAIChoice = bestSquare;
-        actionForEmptyHolder(&_grid[bestSquare / 3][bestSquare % 3]);
-        endTurn();
+        _board.setOwner(index, (uint8_t)owner);
+        syncHolder(index);
     }
 }
 
-bool TicTacToe::aiTestForTerminalState(const std::string& state) {
-    return state.find('0') == std::string::npos;
+void TicTacToe::setStateString(const std::string &s) {
+    if (s.size() < 9) {
+        return;
+    }
+    StateArray state;
+    std::copy_n(s.begin(), 9, state.begin());
+    setStateArray(state);
 }
 
-int TicTacToe::aiBoardEvaluation(const std::string& state) {
-    // Check for winner in all 8 winning combinations
-    for (int i = 0; i < 8; i++) {
-        char first = state[WINNING_COMBOS[i][0]];
-        char second = state[WINNING_COMBOS[i][1]];
-        char third = state[WINNING_COMBOS[i][2]];
-        
-        // Check if AI player (2) wins
-        if (first == '2' && second == '2' && third == '2') {
-            return 10;
+void TicTacToe::setPackedState(uint32_t packed) {
+    StateArray state;
+    for (int index = 0; index < 9; index++) {
+        state[index] = (char)('0' + ((packed >> (index * 2)) & 3));
+    }
+    setStateArray(state);
 }
-        // Check if human player (1) wins
-        if (first == '1' && second == '1' && third == '1') {
-            return -10;
+
+//
+// this is the function that will be called by the AI
+// the search itself is TicTacToeBitboard::bestMove, shared with the session server so both answer the same way
+//
+void TicTacToe::updateAI() {
+    PROFILE_SCOPE("updateAI");
+    MEMORY_SCOPE(Game);
+    auto searchStart = std::chrono::steady_clock::now();
+
+    // X and O bitboards straight from the owner bytes
+    TicTacToeBitboard board;
+    for (int index = 0; index < 9; index++) {
+        int owner = _board.contains(index) ? _board.owner(index) : 0;
+        if (owner == 1 || owner == 2) {
+            board.cells[owner - 1] |= (uint16_t)(1u << index);
         }
     }
 
-    return 0;
-}
+    _lastAIEvaluations.clear();
+    _lastAIChoice = -1;
+    _aiNodes = 0;
 
-int TicTacToe::negamax(std::string state, int depth, int alpha, int beta, int playerColor) {
-    // Check for winner first
-    int score = aiBoardEvaluation(state);
-    if (score != 0) {
-        // Return score adjusted by depth to prefer faster wins/losses
-        // Subtract depth so immediate wins are valued more than distant wins
-        return (score - depth) * playerColor;
-    }
-    
-    // Check for draw (board full)
-    if (aiTestForTerminalState(state) || depth >= 9) {
-        return 0; // Draw
-    }
-    
-    int maxEval = -10000;
-    
+    // AI is player 2 (O)
+    int evaluations[9];
+    int bestSquare = board.bestMove(1, &_aiNodes, evaluations);
+
+    // Track evaluations for debugging
     for (int i = 0; i < 9; i++) {
-        if (state[i] == '0') {
-            state[i] = (playerColor == AI_PLAYER ? '2' : '1');
-            int eval = -negamax(state, depth + 1, -beta, -alpha, -playerColor);
-            
-            // Undo move
-            state[i] = '0';
-            
-            // Update best value
-            maxEval = (eval > maxEval) ? eval : maxEval;
-            alpha = (eval > alpha) ? eval : alpha;
-            
-            // Alpha-beta pruning
-            if (alpha >= beta) {
-                break;
-            }
+        if (board.isEmpty(i)) {
+            _lastAIEvaluations.push_back({i, evaluations[i]});
         }
     }
-    return maxEval;  // Return the best evaluation found
-}
\ No newline at end of file
+
+    // Make the best move
+    if (bestSquare != -1) {
+        _lastAIChoice = bestSquare;
+        _turnAINodes = _aiNodes;
+        _turnAIMicros = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - searchStart).count();
+        applyMove(bestSquare);
+    }
+}
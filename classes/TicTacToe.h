@@ -1,6 +1,10 @@
 #pragma once
 #include "Game.h"
 #include "Square.h"
+#include "BitPool.h"
+#include "TicTacToeBitboard.h"
+#include <array>
+#include <cstdint>
 
 //
 // the classic game of tic tac toe
@@ -13,7 +17,7 @@ class TicTacToe : public Game
 {
 public:
     TicTacToe();
-    ~TicTacToe();
+    ~TicTacToe() override;
 
     // set up the board
     void        setUpBoard() override;
@@ -23,7 +27,18 @@ public:
     std::string initialStateString() override;
     std::string stateString() const override;
     void        setStateString(const std::string &s) override;
+
+    // fixed-size encodings of the board, std::string versions above wrap these
+    // StateArray: one char per square, '0' empty, '1' X (player 1), '2' O (player 2)
+    using StateArray = std::array<char, 9>;
+    StateArray  stateArray() const;
+    // only squares that differ from the current board are touched
+    void        setStateArray(const StateArray &state);
+    // packed: 2 bits per square, square 0 in the lowest bits (0 empty, 1 X, 2 O)
+    uint32_t    packedState() const;
+    void        setPackedState(uint32_t packed);
     bool        actionForEmptyHolder(BitHolder *holder) override;
+    Bit *       pieceForPlayer(int playerNumber) override;
     bool        canBitMoveFrom(Bit*bit, BitHolder *src) override;
     bool        canBitMoveFromTo(Bit* bit, BitHolder*src, BitHolder*dst) override;
     void        stopGame() override;
@@ -35,17 +50,16 @@ public:
     // AI evaluation tracking
     std::vector<std::pair<int, int>> getLastAIEvaluations() const { return _lastAIEvaluations; }
     int getLastAIChoice() const { return _lastAIChoice; }
+    uint32_t getLastAINodes() const { return _aiNodes; }
     
 private:
-    Bit *       PieceForPlayer(const int playerNumber);
     Player*     ownerAt(int index ) const;
-    bool        aiTestForTerminalState(const std::string& state);
-    int         aiBoardEvaluation(const std::string& state);
-    int         negamax(std::string state, int depth, int alpha, int beta, int playerColor);
     
     std::vector<std::pair<int, int>> _lastAIEvaluations;  // pair of (position, score)
     int _lastAIChoice;
+    uint32_t _aiNodes;                                    // negamax nodes visited by the last updateAI
 
+    BitPool     _bitPool;       // declared before the grid so it outlives the holders
     Square      _grid[3][3];
 };
 
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+
+//
+// tic tac toe rules on bitboards
+// one 9-bit mask per player, square index = y * 3 + x maps to bit (1 << index)
+// used where the sprite board would be too heavy: record scanning, self-play, bulk sessions and the AI search
+//
+struct TicTacToeBitboard
+{
+	static constexpr uint16_t kFullBoard = 0x1ff;
+	static constexpr uint16_t kWinMasks[8] = {
+		0x007, 0x038, 0x1c0,	// rows
+		0x049, 0x092, 0x124,	// columns
+		0x111, 0x054			// diagonals
+	};
+
+	uint16_t	cells[2] = { 0, 0 };	// player 0 (X), player 1 (O)
+
+	static bool	isWin(uint16_t bits)
+	{
+		for (uint16_t mask : kWinMasks) {
+			if ((bits & mask) == mask) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	uint16_t	occupied() const { return (uint16_t)(cells[0] | cells[1]); }
+	uint16_t	empty() const { return (uint16_t)(~occupied() & kFullBoard); }
+	bool		isEmpty(int square) const { return (occupied() & (1u << square)) == 0; }
+	bool		full() const { return occupied() == kFullBoard; }
+	int			moveCount() const;
+
+	// -1 none, otherwise the winning player
+	int			winner() const { return isWin(cells[0]) ? 0 : (isWin(cells[1]) ? 1 : -1); }
+	bool		gameOver() const { return full() || winner() >= 0; }
+
+	// returns false if the square is taken or out of range
+	bool		play(int square, int player)
+	{
+		if (square < 0 || square > 8 || !isEmpty(square)) {
+			return false;
+		}
+		cells[player] |= (uint16_t)(1u << square);
+		return true;
+	}
+	void		unplay(int square, int player) { cells[player] &= (uint16_t)~(1u << square); }
+
+	// the one tic tac toe AI: TicTacToe::updateAI and the session server both call this, so the same position
+	// gets the same answer everywhere
+	// alpha-beta negamax from the side to move, scored like the original desktop search: a line for O is
+	// 10 - depth and a line for X is -10 - depth (from O's side, depth counted from 0 after the first move)
+	// returns the best square (lowest index on ties), or -1 if the game is already over
+	// evaluations, if given, gets each empty square's score for player (other entries are left alone)
+	int			bestMove(int player, uint32_t *nodes = nullptr, int *evaluations = nullptr) const;
+
+	// owner of a square: 0 empty, 1 X, 2 O (the state string digit)
+	int			ownerAt(int square) const
+	{
+		uint16_t bit = (uint16_t)(1u << square);
+		return (cells[0] & bit) ? 1 : ((cells[1] & bit) ? 2 : 0);
+	}
+};
+
+inline int TicTacToeBitboard::moveCount() const
+{
+	int count = 0;
+	for (uint16_t bits = occupied(); bits; bits &= (uint16_t)(bits - 1)) {
+		count++;
+	}
+	return count;
+}
+
+namespace TicTacToeBitboardSearch {
+	inline int negamax(TicTacToeBitboard &board, int player, int depth, int alpha, int beta, uint32_t &nodes)
+	{
+		nodes++;
+		// only the player who just moved can have won; the score is O's, flipped when X is to move
+		if (TicTacToeBitboard::isWin(board.cells[player ^ 1])) {
+			int score = (player ^ 1) == 1 ? 10 : -10;
+			return (score - depth) * (player == 1 ? 1 : -1);
+		}
+		uint16_t empty = board.empty();
+		if (empty == 0 || depth >= 9) {
+			return 0;
+		}
+		int best = -10000;
+		for (int square = 0; square < 9; square++) {
+			if (!(empty & (1u << square))) {
+				continue;
+			}
+			board.cells[player] |= (uint16_t)(1u << square);
+			int eval = -negamax(board, player ^ 1, depth + 1, -beta, -alpha, nodes);
+			board.cells[player] &= (uint16_t)~(1u << square);
+			best = eval > best ? eval : best;
+			alpha = eval > alpha ? eval : alpha;
+			if (alpha >= beta) {
+				break;
+			}
+		}
+		return best;
+	}
+}
+
+inline int TicTacToeBitboard::bestMove(int player, uint32_t *nodes, int *evaluations) const
+{
+	if (gameOver()) {
+		return -1;
+	}
+	TicTacToeBitboard board = *this;
+	uint32_t visited = 0;
+	int bestSquare = -1;
+	int bestEval = -10000;
+	uint16_t open = empty();
+	for (int square = 0; square < 9; square++) {
+		if (!(open & (1u << square))) {
+			continue;
+		}
+		board.cells[player] |= (uint16_t)(1u << square);
+		int eval = -TicTacToeBitboardSearch::negamax(board, player ^ 1, 0, -10000, 10000, visited);
+		board.cells[player] &= (uint16_t)~(1u << square);
+		if (evaluations) {
+			evaluations[square] = eval;
+		}
+		if (eval > bestEval) {
+			bestEval = eval;
+			bestSquare = square;
+		}
+	}
+	if (nodes) {
+		*nodes = visited;
+	}
+	return bestSquare;
+}
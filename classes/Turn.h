@@ -1,33 +1,13 @@
 #pragma once
-#include <iostream>
+#include <cstdint>
 
-class Game;
-class Player;
-
-typedef enum {
-	kTurnEmpty,             // No action yet
-	kTurnPartial,           // Action taken, but more needs to be done
-	kTurnComplete,          // Action complete, but player needs to confirm
-	kTurnFinished           // Turn is confirmed and finished
-} TurnStatus;
-
-class Turn
+//
+// compact history entry, one per finished turn
+// board snapshots are rebuilt on demand by replaying the move list from the start state
+//
+struct TurnRecord
 {
-public:
-	Turn() : _game(nullptr), _player(nullptr), _status(kTurnEmpty), _move(""), _boardState(""), _date(0), _comment(""), _score(0), _replaying(false), _gameNumber(-1) {};
-	~Turn() {};
-
-	static	Turn *initStartOfGame(Game *game) { Turn *turn = new Turn(); turn->_game = game; turn->_status = kTurnFinished; return turn; };
-	void	setStateString(std::string board) { _boardState = board; };
-	Game		*_game;
-	Player		*_player;
-	TurnStatus	_status;
-	std::string	_move;
-	std::string	_boardState;
-	int			_date;
-	std::string	_comment;
-	int			_score;
-	bool		_replaying;
-	int			_gameNumber;
+	int16_t		square;			// holder index (y * rowX + x), -1 for the start-of-game record
+	int16_t		score;
+	uint8_t		player;			// zero-based player number that made the move
 };
-
@@ -0,0 +1,240 @@
+// In-process load generator: many TicTacToe instances driven from worker threads, no window or renderer
+//
+// usage: loadgen [--games N] [--threads M] [--rate movesPerSecond] [--seconds S] [--script 4,0,8,...] [--seed X] [--trace file]
+//   N games (default 1000) are split evenly over M threads (default 4); each thread plays human moves on its
+//   games round-robin and lets the AI answer, for S seconds (default 5)
+//   --rate spreads that many human moves per second over all threads (default 0 = as fast as possible)
+//   --script makes the human try these squares in order (falling back to random when they're all taken)
+//   --trace captures every PROFILE_SCOPE on the worker threads and writes it as Chrome trace JSON
+//
+// reports latency percentiles for the human move (applyMove), the AI reply (updateAI) and the whole exchange
+// measured from its scheduled start, so a thread that falls behind the target rate shows up as latency
+// with memory tracking built in, also the Game-tagged heap traffic and whether it all came back once the games were gone
+
+#include "classes/TicTacToe.h"
+#include "LatencyHistogram.h"
+#include "MemoryTracker.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct LoadOptions {
+    int games = 1000;
+    int threads = 4;
+    double rate = 0.0;
+    double seconds = 5.0;
+    std::vector<int> script;
+    uint32_t seed = 1;
+    std::string trace;
+};
+
+struct LoadTotals {
+    std::mutex mutex;
+    ClassGame::LatencyHistogram move;
+    ClassGame::LatencyHistogram ai;
+    ClassGame::LatencyHistogram exchange;
+    uint64_t moves = 0;
+    uint64_t games = 0;
+    uint64_t results[3] = { 0, 0, 0 };   // X, O, draw
+};
+
+// one hosted game, its end turn handler replaces Application's game-over bookkeeping
+struct LoadGame {
+    std::unique_ptr<TicTacToe> game;
+    bool over = false;
+    int winner = -1;
+};
+
+static uint64_t Nanoseconds(Clock::duration duration) {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+
+static void RunWorker(const LoadOptions& options, int gameCount, LoadTotals& totals, std::barrier<>& ready, uint32_t seed, int index) {
+    ClassGame::Tracer::GetInstance().SetThreadName("loadgen " + std::to_string(index));
+    std::vector<LoadGame> games((size_t)gameCount);
+    for (LoadGame& slot : games) {
+        MEMORY_SCOPE(Game);
+        slot.game = std::make_unique<TicTacToe>();
+        slot.game->setEndTurnHandler([&slot](Game* game) {
+            Player* winner = game->checkForWinner();
+            if (winner || game->checkForDraw()) {
+                slot.over = true;
+                slot.winner = winner ? winner->playerNumber() : -1;
+            }
+        });
+        slot.game->setUpBoard();
+    }
+    // every board is up, wait while main takes its baseline so setup stays out of the play figures
+    ready.arrive_and_wait();
+    ready.arrive_and_wait();
+
+    std::mt19937 rng(seed);
+    ClassGame::LatencyHistogram moveTimes, aiTimes, exchangeTimes;
+    uint64_t moves = 0, finished = 0;
+    uint64_t results[3] = { 0, 0, 0 };
+
+    // each thread gets an equal share of the target rate
+    double perThreadRate = options.rate > 0.0 ? options.rate * gameCount / options.games : 0.0;
+    auto interval = perThreadRate > 0.0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / perThreadRate)) : Clock::duration::zero();
+    auto start = Clock::now();
+    auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.seconds));
+
+    for (uint64_t k = 0;; k++) {
+        auto scheduled = perThreadRate > 0.0 ? start + interval * (int64_t)k : Clock::now();
+        if (scheduled >= end) break;
+        if (perThreadRate > 0.0) std::this_thread::sleep_until(scheduled);
+        else if ((k & 63) == 0 && Clock::now() >= end) break;
+
+        LoadGame& slot = games[k % games.size()];
+        TicTacToe& game = *slot.game;
+        TicTacToe::StateArray state = game.stateArray();
+
+        // scripted square if one is still free, otherwise a random empty one
+        int square = -1;
+        for (int candidate : options.script) {
+            if (candidate >= 0 && candidate < 9 && state[candidate] == '0') {
+                square = candidate;
+                break;
+            }
+        }
+        if (square < 0) {
+            int empty = (int)std::count(state.begin(), state.end(), '0');
+            int pick = (int)(rng() % (uint32_t)empty);
+            for (square = 0; state[square] != '0' || pick-- > 0; square++) {}
+        }
+
+        auto moveStart = Clock::now();
+        game.applyMove(square);
+        auto moveDone = Clock::now();
+        if (!slot.over) {
+            game.updateAI();
+        }
+        auto aiDone = Clock::now();
+
+        moveTimes.Record(Nanoseconds(moveDone - moveStart));
+        if (aiDone > moveDone) aiTimes.Record(Nanoseconds(aiDone - moveDone));
+        exchangeTimes.Record(Nanoseconds(aiDone - (perThreadRate > 0.0 ? scheduled : moveStart)));
+        moves++;
+
+        if (slot.over) {
+            finished++;
+            results[slot.winner < 0 ? 2 : slot.winner]++;
+            game.stopGame();
+            game.setUpBoard();
+            slot.over = false;
+            slot.winner = -1;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(totals.mutex);
+    totals.move.Merge(moveTimes);
+    totals.ai.Merge(aiTimes);
+    totals.exchange.Merge(exchangeTimes);
+    totals.moves += moves;
+    totals.games += finished;
+    for (int i = 0; i < 3; i++) totals.results[i] += results[i];
+}
+
+static bool ParseOptions(int argc, char** argv, LoadOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+        if (arg == "--games") options.games = std::max(1, atoi(value));
+        else if (arg == "--threads") options.threads = std::max(1, atoi(value));
+        else if (arg == "--rate") options.rate = std::max(0.0, atof(value));
+        else if (arg == "--seconds") options.seconds = std::max(0.1, atof(value));
+        else if (arg == "--seed") options.seed = (uint32_t)strtoul(value, nullptr, 10);
+        else if (arg == "--trace") options.trace = value;
+        else if (arg == "--script") {
+            std::stringstream list(value);
+            std::string square;
+            while (std::getline(list, square, ',')) options.script.push_back(atoi(square.c_str()));
+        } else return false;
+    }
+    options.threads = std::min(options.threads, options.games);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    LoadOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        fprintf(stderr, "usage: loadgen [--games N] [--threads M] [--rate movesPerSecond] [--seconds S] [--script 4,0,8,...] [--seed X] [--trace file]\n");
+        return 2;
+    }
+
+    ClassGame::Tracer& tracer = ClassGame::Tracer::GetInstance();
+    if (!options.trace.empty()) {
+        tracer.Start();
+    }
+
+    LoadTotals totals;
+    ClassGame::MemoryTracker::Stats memoryStart = ClassGame::MemoryTracker::Get(ClassGame::MemoryTag::Game);
+    std::barrier<> ready(options.threads + 1);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < options.threads; i++) {
+        int first = options.games * i / options.threads;
+        int count = options.games * (i + 1) / options.threads - first;
+        threads.emplace_back(RunWorker, std::cref(options), count, std::ref(totals), std::ref(ready), options.seed + (uint32_t)i, i);
+    }
+    // first phase: all boards set up; the second lets the workers start playing
+    ready.arrive_and_wait();
+    ClassGame::MemoryTracker::Stats memoryPlay = ClassGame::MemoryTracker::Get(ClassGame::MemoryTag::Game);
+    auto start = Clock::now();
+    ready.arrive_and_wait();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    printf("%d games on %d thread(s), target %s: %llu human moves (%.1f/s), %llu games finished\n",
+           options.games, options.threads, options.rate > 0.0 ? (std::to_string((int)options.rate) + " moves/s").c_str() : "unthrottled",
+           (unsigned long long)totals.moves, (double)totals.moves / seconds, (unsigned long long)totals.games);
+    printf("results: X %llu | O (AI) %llu | draws %llu\n",
+           (unsigned long long)totals.results[0], (unsigned long long)totals.results[1], (unsigned long long)totals.results[2]);
+    printf("applyMove: %s\n", totals.move.Summary().c_str());
+    printf("updateAI:  %s\n", totals.ai.Summary().c_str());
+    printf("exchange:  %s\n", totals.exchange.Summary().c_str());
+    if (ClassGame::MemoryTracker::IsTracking()) {
+        // allocations count from the end of setup (tearing the games down only frees); every game has been
+        // destroyed by now, so anything still live since before setup is a leak
+        ClassGame::MemoryTracker::Stats memory = ClassGame::MemoryTracker::Get(ClassGame::MemoryTag::Game);
+        uint64_t setup = memoryPlay.allocations - memoryStart.allocations;
+        uint64_t allocations = memory.allocations - memoryPlay.allocations;
+        printf("memory:    %llu setup allocations, %llu during play (%.2f per finished game, %.3f per move), peak %.1f KB, %lld bytes still live\n",
+               (unsigned long long)setup, (unsigned long long)allocations, totals.games ? (double)allocations / totals.games : 0.0,
+               totals.moves ? (double)allocations / totals.moves : 0.0, memory.peakBytes / 1024.0,
+               (long long)(memory.liveBytes - memoryStart.liveBytes));
+    }
+    std::string liveEntities = Entity::liveReport();
+    printf("entities:  %s\n", liveEntities.empty() ? "none left after the games were destroyed" : (liveEntities + " still alive").c_str());
+
+    if (!options.trace.empty()) {
+        tracer.Stop();
+        std::string error;
+        uint64_t events, dropped;
+        int traced;
+        tracer.Counts(events, dropped, traced);
+        if (!tracer.Save(options.trace, &error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        printf("trace: %llu events on %d thread(s), %llu dropped -> %s\n", (unsigned long long)events, traced,
+               (unsigned long long)dropped, options.trace.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Headless driver: runs the game and the console command layer without a window or renderer
+//
+// usage: headless [script ...]
+//   each script is executed line by line through the same commands as the Game Log console;
+//   with no scripts (or "-") commands are read from stdin
+//   per-command wall time is logged, the exit code is non-zero if any command failed
+//
+// usage: headless --serve <address> [shards]
+//   network play server (see classes/PlayProtocol.h), runs until SIGINT / SIGTERM
+//   address is "unix:/path", "host:port" or "port"; drive it with netclient
+
+#include "Application.h"
+#include "Command.h"
+#include "Logger.h"
+#include "classes/PlayServer.h"
+#include <iostream>
+#include <memory>
+#include <cstring>
+#include <csignal>
+#include <cstdlib>
+
+static PlayServer* activeServer = nullptr;
+
+static void StopServer(int) {
+    if (activeServer) activeServer->stop();
+}
+
+static int Serve(const std::string& address, int shards) {
+    SessionManager sessions(shards);
+    PlayServer server(sessions);
+    std::string error;
+    if (!server.listen(address, &error)) {
+        LOG_ERROR_TAG(error, "SERVER");
+        return 1;
+    }
+    LOG_INFO_TAG("Serving on " + address + " with " + std::to_string(sessions.shardCount()) + " session shard(s)", "SERVER");
+
+    activeServer = &server;
+    std::signal(SIGINT, StopServer);
+    std::signal(SIGTERM, StopServer);
+    server.run();
+    activeServer = nullptr;
+
+    LOG_INFO_TAG("Served " + std::to_string(server.requestsServed()) + " requests on " + std::to_string(server.connectionsAccepted()) +
+                 " connection(s) | service time " + server.serviceTimes().Summary(), "SERVER");
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    ClassGame::GameStartUp();
+
+    ClassGame::Logger& logger = ClassGame::Logger::GetInstance();
+    if (!logger.FindSink("console")) {
+        logger.AddSink(std::make_unique<ClassGame::ConsoleSink>());
+    }
+
+    if (argc >= 3 && strcmp(argv[1], "--serve") == 0) {
+        int result = Serve(argv[2], argc >= 4 ? atoi(argv[3]) : 0);
+        ClassGame::GameShutDown();
+        logger.Shutdown();
+        return result;
+    }
+
+    int failures = 0;
+    if (argc < 2) {
+        failures = ClassGame::Command::ExecStream(std::cin, "stdin");
+    } else {
+        for (int i = 1; i < argc; i++) {
+            int result = strcmp(argv[i], "-") == 0
+                ? ClassGame::Command::ExecStream(std::cin, "stdin")
+                : ClassGame::Command::ExecScript(argv[i]);
+            failures += (result < 0) ? 1 : result;
+        }
+    }
+
+    ClassGame::GameShutDown();
+    logger.Shutdown();
+    return failures == 0 ? 0 : 1;
+}
@@ -11,12 +11,15 @@
 #include "imgui/imgui_impl_glfw.h"
 #include "imgui/imgui_impl_opengl3.h"
 #include <stdio.h>
+#include <chrono>
 #define GL_SILENCE_DEPRECATION
 #if defined(IMGUI_IMPL_OPENGL_ES2)
 #include <GLES2/gl2.h>
 #endif
 #include <GLFW/glfw3.h> // Will drag system OpenGL headers
 #include "Application.h"
+#include "MemoryTracker.h"
+#include "Profiler.h"
 
 // [Win32] Our example includes a copy of glfw3.lib pre-compiled with VS2010 to maximize ease of testing and compatibility with old VS compilers.
 // To link with VS2010-era libraries, VS2015+ requires linking with legacy_stdio_definitions.lib, which we do using this pragma.
@@ -35,6 +38,24 @@ static void glfw_error_callback(int error, const char* description)
     fprintf(stderr, "GLFW Error %d: %s\n", error, description);
 }
 
+// Resizes and exposes don't reach imgui's input queue, so ask for a redraw directly
+static void glfw_redraw_callback(GLFWwindow*)
+{
+    ClassGame::RequestRedraw();
+}
+
+static void glfw_resize_callback(GLFWwindow*, int, int)
+{
+    ClassGame::RequestRedraw();
+}
+
+// Installed before imgui's backend, which chains to it, so the latency probe sees presses as GLFW delivers them
+static void glfw_mouse_button_callback(GLFWwindow*, int button, int action, int)
+{
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
+        ClassGame::InputEvent();
+}
+
 // Main code
 int main(int, char**)
 {
@@ -71,9 +92,13 @@ int main(int, char**)
         return 1;
     glfwMakeContextCurrent(window);
     glfwSwapInterval(1); // Enable vsync
+    glfwSetWindowRefreshCallback(window, glfw_redraw_callback);
+    glfwSetFramebufferSizeCallback(window, glfw_resize_callback);
+    glfwSetMouseButtonCallback(window, glfw_mouse_button_callback);
 
     // Setup Dear ImGui context
     IMGUI_CHECKVERSION();
+    ClassGame::MemoryTracker::InstallImGuiAllocator();
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO(); (void)io;
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;     // Enable Keyboard Controls
@@ -137,36 +162,64 @@ int main(int, char**)
         // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
         // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application, or clear/overwrite your copy of the keyboard data.
         // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
+#ifdef __EMSCRIPTEN__
         glfwPollEvents();
+#else
+        // Idle-aware: with no input, AI move or redraw pending, block for events instead of spinning,
+        // and skip the frame entirely if the wakeup (or timeout) didn't change anything
+        if (ClassGame::NeedsRedraw())
+            glfwPollEvents();
+        else
+            glfwWaitEventsTimeout(ClassGame::IdleWaitSeconds());
+        if (!ClassGame::NeedsRedraw())
+        {
+            ClassGame::FrameSkipped();
+            continue;
+        }
+#endif
+        auto frame_start = std::chrono::steady_clock::now();
+        ClassGame::Profiler& profiler = ClassGame::Profiler::GetInstance();
+        profiler.BeginFrame();
 
         // Start the Dear ImGui frame
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
-        ImGui::NewFrame();
+        {
+            PROFILE_SCOPE("NewFrame");
+            ImGui_ImplOpenGL3_NewFrame();
+            ImGui_ImplGlfw_NewFrame();
+            ImGui::NewFrame();
+        }
 
         ClassGame::RenderGame();
 
         // Rendering
-        ImGui::Render();
-        int display_w, display_h;
-        glfwGetFramebufferSize(window, &display_w, &display_h);
-        glViewport(0, 0, display_w, display_h);
-        glClearColor(clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w, clear_color.w);
-        glClear(GL_COLOR_BUFFER_BIT);
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        {
+            PROFILE_SCOPE("Render");
+            ImGui::Render();
+            int display_w, display_h;
+            glfwGetFramebufferSize(window, &display_w, &display_h);
+            glViewport(0, 0, display_w, display_h);
+            glClearColor(clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w, clear_color.w);
+            glClear(GL_COLOR_BUFFER_BIT);
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
 
         // Update and Render additional Platform Windows
         // (Platform functions may change the current OpenGL context, so we save/restore it to make it easier to paste this code elsewhere.
         //  For this specific demo app we could also call glfwMakeContextCurrent(window) directly)
         if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
         {
+            PROFILE_SCOPE("Platform Windows");
             GLFWwindow* backup_current_context = glfwGetCurrentContext();
             ImGui::UpdatePlatformWindows();
             ImGui::RenderPlatformWindowsDefault();
             glfwMakeContextCurrent(backup_current_context);
         }
 
+        // frame time up to (not including) the vsync wait in swap
+        profiler.EndFrame();
+        ClassGame::FrameRendered(std::chrono::duration<double>(std::chrono::steady_clock::now() - frame_start).count());
         glfwSwapBuffers(window);
+        ClassGame::FramePresented();
     }
 #ifdef __EMSCRIPTEN__
     EMSCRIPTEN_MAINLOOP_END;
@@ -176,6 +229,7 @@ int main(int, char**)
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
+    ClassGame::GameShutDown();
 
     glfwDestroyWindow(window);
     glfwTerminate();
@@ -12,6 +12,8 @@
 #include <d3d11.h>
 #include <tchar.h>
 #include "Application.h"
+#include "MemoryTracker.h"
+#include "Profiler.h"
 
 // Data
 ID3D11Device*            g_pd3dDevice = nullptr;
@@ -54,6 +56,7 @@ int main(int, char**)
 
     // Setup Dear ImGui context
     IMGUI_CHECKVERSION();
+    ClassGame::MemoryTracker::InstallImGuiAllocator();
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO(); (void)io;
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;     // Enable Keyboard Controls
@@ -114,6 +117,9 @@ int main(int, char**)
     {
         // Poll and handle messages (inputs, window resize, etc.)
         // See the WndProc() function below for our to dispatch events to the Win32 backend.
+        // Idle-aware: with no input, AI move or redraw pending, sleep until a message arrives (see main_macos.cpp)
+        if (!ClassGame::NeedsRedraw())
+            ::MsgWaitForMultipleObjects(0, nullptr, FALSE, (DWORD)(ClassGame::IdleWaitSeconds() * 1000.0), QS_ALLINPUT);
         MSG msg;
         while (::PeekMessage(&msg, nullptr, 0U, 0U, PM_REMOVE))
         {
@@ -124,6 +130,11 @@ int main(int, char**)
         }
         if (done)
             break;
+        if (!ClassGame::NeedsRedraw() && g_ResizeWidth == 0)
+        {
+            ClassGame::FrameSkipped();
+            continue;
+        }
 
         // Handle window being minimized or screen locked
         if (g_SwapChainOccluded && g_pSwapChain->Present(0, DXGI_PRESENT_TEST) == DXGI_STATUS_OCCLUDED)
@@ -143,35 +154,54 @@ int main(int, char**)
         }
 
         // Start the Dear ImGui frame
-        ImGui_ImplDX11_NewFrame();
-        ImGui_ImplWin32_NewFrame();
-        ImGui::NewFrame();
+        LARGE_INTEGER frame_start, frame_end, frequency;
+        ::QueryPerformanceCounter(&frame_start);
+        ClassGame::Profiler& profiler = ClassGame::Profiler::GetInstance();
+        profiler.BeginFrame();
+        {
+            PROFILE_SCOPE("NewFrame");
+            ImGui_ImplDX11_NewFrame();
+            ImGui_ImplWin32_NewFrame();
+            ImGui::NewFrame();
+        }
         ClassGame::RenderGame();
 
         // Rendering
-        ImGui::Render();
-        const float clear_color_with_alpha[4] = { clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w, clear_color.w };
-        g_pd3dDeviceContext->OMSetRenderTargets(1, &g_mainRenderTargetView, nullptr);
-        g_pd3dDeviceContext->ClearRenderTargetView(g_mainRenderTargetView, clear_color_with_alpha);
-        ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+        {
+            PROFILE_SCOPE("Render");
+            ImGui::Render();
+            const float clear_color_with_alpha[4] = { clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w, clear_color.w };
+            g_pd3dDeviceContext->OMSetRenderTargets(1, &g_mainRenderTargetView, nullptr);
+            g_pd3dDeviceContext->ClearRenderTargetView(g_mainRenderTargetView, clear_color_with_alpha);
+            ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+        }
 
         // Update and Render additional Platform Windows
         if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
         {
+            PROFILE_SCOPE("Platform Windows");
             ImGui::UpdatePlatformWindows();
             ImGui::RenderPlatformWindowsDefault();
         }
 
+        // frame time up to (not including) the vsync wait in Present
+        profiler.EndFrame();
+        ::QueryPerformanceCounter(&frame_end);
+        ::QueryPerformanceFrequency(&frequency);
+        ClassGame::FrameRendered((double)(frame_end.QuadPart - frame_start.QuadPart) / (double)frequency.QuadPart);
+
         // Present
         HRESULT hr = g_pSwapChain->Present(1, 0);   // Present with vsync
         //HRESULT hr = g_pSwapChain->Present(0, 0); // Present without vsync
         g_SwapChainOccluded = (hr == DXGI_STATUS_OCCLUDED);
+        ClassGame::FramePresented();
     }
 
     // Cleanup
     ImGui_ImplDX11_Shutdown();
     ImGui_ImplWin32_Shutdown();
     ImGui::DestroyContext();
+    ClassGame::GameShutDown();
 
     CleanupDeviceD3D();
     ::DestroyWindow(hwnd);
@@ -245,6 +275,10 @@ extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg
 // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
 LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
+    // latency probe: GetMessageTime() says how long the press waited in the queue before we got to it
+    if (msg == WM_LBUTTONDOWN)
+        ClassGame::InputEvent((DWORD)(::GetTickCount() - (DWORD)::GetMessageTime()) / 1000.0);
+
     if (ImGui_ImplWin32_WndProcHandler(hWnd, msg, wParam, lParam))
         return true;
 
@@ -0,0 +1,206 @@
+// Load generator for the network play server (headless --serve)
+//
+// usage: netclient <address> [connections] [games] [pipeline]
+//   opens <connections> sockets (one thread each), keeps <pipeline> games in flight per socket and plays
+//   random legal moves against the server's AI until <games> games have finished in total
+//   reports request throughput and the round-trip latency distribution
+//
+// defaults: 4 connections, 10000 games, pipeline 16
+
+#include "classes/PlayProtocol.h"
+#include "classes/TicTacToeBitboard.h"
+#include "LatencyHistogram.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/socket.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+struct ClientTotals {
+    std::mutex mutex;
+    ClassGame::LatencyHistogram latency;
+    uint64_t requests = 0;
+    uint64_t games = 0;
+    uint64_t errors = 0;
+    uint64_t results[3] = { 0, 0, 0 };   // X, O, draw
+};
+
+// one game slot per pipeline entry, each with at most one request outstanding (seq = slot index)
+struct GameSlot {
+    uint64_t session = 0;
+    Clock::time_point sent;
+    bool active = false;
+};
+
+#ifndef _WIN32
+
+static bool SendAll(int fd, const std::vector<PlayRequestFrame>& frames) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(frames.data());
+    size_t length = frames.size() * sizeof(PlayRequestFrame);
+    while (length > 0) {
+        ssize_t sent = send(fd, data, length, MSG_NOSIGNAL);
+        if (sent <= 0) return false;
+        data += sent;
+        length -= (size_t)sent;
+    }
+    return true;
+}
+
+static void RunConnection(const std::string& address, int pipeline, std::atomic<int64_t>& gamesLeft, ClientTotals& totals, uint32_t seed) {
+    std::string error;
+    int fd = PlayConnect(address, &error);
+    if (fd < 0) {
+        std::lock_guard<std::mutex> lock(totals.mutex);
+        std::cerr << error << std::endl;
+        totals.errors++;
+        return;
+    }
+
+    std::mt19937 rng(seed);
+    ClassGame::LatencyHistogram latency;
+    uint64_t requests = 0, games = 0, errors = 0;
+    uint64_t results[3] = { 0, 0, 0 };
+    std::vector<GameSlot> slots((size_t)pipeline);
+    std::vector<PlayRequestFrame> outgoing;
+    int inFlight = 0;
+
+    auto issue = [&](int slot, uint8_t op, int8_t arg, uint64_t session) {
+        PlayRequestFrame frame = {};
+        frame.op = op;
+        frame.arg = arg;
+        frame.seq = (uint32_t)slot;
+        frame.session = session;
+        outgoing.push_back(frame);
+        slots[slot].sent = Clock::now();
+        inFlight++;
+    };
+    // claim a game from the shared budget, the AI plays O
+    auto startGame = [&](int slot) {
+        if (gamesLeft.fetch_sub(1) <= 0) {
+            slots[slot].active = false;
+            return;
+        }
+        slots[slot].active = true;
+        issue(slot, kPlayCreate, 2, 0);
+    };
+
+    for (int slot = 0; slot < pipeline; slot++) {
+        startGame(slot);
+    }
+
+    std::vector<uint8_t> input;
+    uint8_t buffer[16 * 1024];
+    while (inFlight > 0) {
+        if (!outgoing.empty()) {
+            if (!SendAll(fd, outgoing)) break;
+            outgoing.clear();
+        }
+        ssize_t got = read(fd, buffer, sizeof(buffer));
+        if (got <= 0) break;
+        input.insert(input.end(), buffer, buffer + got);
+
+        size_t offset = 0;
+        auto now = Clock::now();
+        for (; offset + sizeof(PlayReplyFrame) <= input.size(); offset += sizeof(PlayReplyFrame)) {
+            PlayReplyFrame reply;
+            memcpy(&reply, input.data() + offset, sizeof(reply));
+            int slot = (int)reply.seq;
+            if (slot < 0 || slot >= pipeline) {
+                errors++;
+                continue;
+            }
+            inFlight--;
+            requests++;
+            latency.Record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now - slots[slot].sent).count());
+
+            if (reply.status != 0) {
+                errors++;
+                startGame(slot);
+                continue;
+            }
+            if (reply.op == kPlayClose) {
+                startGame(slot);
+                continue;
+            }
+            slots[slot].session = reply.session;
+            if (reply.over) {
+                games++;
+                results[reply.winner < 0 ? 2 : reply.winner]++;
+                issue(slot, kPlayClose, 0, reply.session);
+                continue;
+            }
+
+            // random legal move
+            uint16_t empty = (uint16_t)(~(reply.cells[0] | reply.cells[1]) & TicTacToeBitboard::kFullBoard);
+            int pick = (int)(rng() % (uint32_t)(9 - reply.moveCount));
+            int square = 0;
+            for (;; square++) {
+                if ((empty & (1u << square)) && pick-- == 0) break;
+            }
+            issue(slot, kPlayMove, (int8_t)square, reply.session);
+        }
+        input.erase(input.begin(), input.begin() + (ptrdiff_t)offset);
+    }
+    close(fd);
+
+    std::lock_guard<std::mutex> lock(totals.mutex);
+    totals.latency.Merge(latency);
+    totals.requests += requests;
+    totals.games += games;
+    totals.errors += errors + (inFlight > 0 ? 1 : 0);
+    for (int i = 0; i < 3; i++) totals.results[i] += results[i];
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: netclient <address> [connections] [games] [pipeline]" << std::endl;
+        return 2;
+    }
+    std::string address = argv[1];
+    int connections = argc > 2 ? std::max(1, atoi(argv[2])) : 4;
+    int64_t games = argc > 3 ? std::max(1, atoi(argv[3])) : 10000;
+    int pipeline = argc > 4 ? std::max(1, atoi(argv[4])) : 16;
+
+    std::atomic<int64_t> gamesLeft{ games };
+    ClientTotals totals;
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < connections; i++) {
+        threads.emplace_back(RunConnection, address, pipeline, std::ref(gamesLeft), std::ref(totals), (uint32_t)(i + 1));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    printf("%d connection(s) x %d in flight: %llu games, %llu requests in %.1f ms (%.1f K req/s)\n",
+           connections, pipeline, (unsigned long long)totals.games, (unsigned long long)totals.requests,
+           seconds * 1000.0, (double)totals.requests / seconds / 1000.0);
+    printf("results: X %llu | O (AI) %llu | draws %llu | errors %llu\n",
+           (unsigned long long)totals.results[0], (unsigned long long)totals.results[1],
+           (unsigned long long)totals.results[2], (unsigned long long)totals.errors);
+    printf("round trip: %s\n", totals.latency.Summary().c_str());
+    return totals.errors == 0 ? 0 : 1;
+}
+
+#else
+
+int main() {
+    std::cerr << "netclient is not supported on this platform" << std::endl;
+    return 1;
+}
+
+#endif